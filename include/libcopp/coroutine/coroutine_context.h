@@ -27,6 +27,34 @@ protected:                                           \
     COROUTINE_CONTEXT_BASE_USING_BASE_SEGMENTED_STACKS(base_type)
 
 namespace copp {
+    namespace detail {
+        /**
+         * @brief exception thrown by yield() inside a coroutine which is being unwinded
+         * @see coroutine_context::unwind
+         * @note catch(...) in a coroutine must rethrow it, or the coroutine will be unwinded again by the next yield()
+         */
+        struct forced_unwind {};
+    } // namespace detail
+
+    class coroutine_context;
+
+    namespace detail {
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+        /**
+         * @brief current coroutine of this thread, it's written by jump_to() and coroutine_context_callback()
+         */
+        extern COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC coroutine_context *gt_current_coroutine;
+#endif
+
+        /**
+         * @brief allocate a coroutine-local slot index
+         * @param destructor called with the slot value when a coroutine is destroyed and the value is not NULL, can be NULL
+         * @note slots are never released, there are at most COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER slots
+         * @return slot index or COPP_EC_OUT_OF_RANGE
+         */
+        int coroutine_local_alloc_slot(void (*destructor)(void *)) UTIL_CONFIG_NOEXCEPT;
+    } // namespace detail
+
     /**
      * @brief base type of all coroutine context
      */
@@ -52,6 +80,7 @@ namespace copp {
             enum type {
                 EN_CFT_UNKNOWN = 0,
                 EN_CFT_FINISHED = 0x01,
+                EN_CFT_UNWINDING = 0x02,
                 EN_CFT_MASK = 0xFF,
             };
         };
@@ -62,6 +91,8 @@ namespace copp {
         callback_t runner_;   /** coroutine runner **/
         void *priv_data_;
         size_t private_buffer_size_;
+        size_t stack_offset_; /** private buffer and coroutine object on the top of stack, reset() makes fcontext below it **/
+        void *local_slots_[COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER]; /** coroutine-local values **/
 
         struct jump_src_data_t {
             coroutine_context *from_co;
@@ -115,14 +146,23 @@ namespace copp {
          * @param priv_data private data, will be passed to runner operator() or return to yield
          * @return COPP_EC_SUCCESS or error code
          */
-        int start(void *priv_data = UTIL_CONFIG_NULLPTR);
+        inline int start(void *priv_data = UTIL_CONFIG_NULLPTR) { return start(priv_data, UTIL_CONFIG_NULLPTR); }
+
+        /**
+         * @brief start coroutine and receive the data passed by yield(priv_data, yield_data)
+         * @param priv_data private data, will be passed to runner operator() or return to yield
+         * @param yield_data if not NULL, will get the yield_data passed to yield(priv_data, yield_data), or NULL if the
+         *        coroutine is suspended by yield(priv_data) or it's finished
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int start(void *priv_data, void **yield_data);
 
         /**
          * @brief resume coroutine
          * @param priv_data private data, will be passed to runner operator() or return to yield
          * @return COPP_EC_SUCCESS or error code
          */
-        int resume(void *priv_data = UTIL_CONFIG_NULLPTR);
+        inline int resume(void *priv_data = UTIL_CONFIG_NULLPTR) { return start(priv_data); }
 
 
         /**
@@ -130,7 +170,33 @@ namespace copp {
          * @param priv_data private data, if not NULL, will get the value from start(priv_data) or resume(priv_data)
          * @return COPP_EC_SUCCESS or error code
          */
-        int yield(void **priv_data = UTIL_CONFIG_NULLPTR);
+        inline int yield(void **priv_data = UTIL_CONFIG_NULLPTR) { return yield(priv_data, UTIL_CONFIG_NULLPTR); }
+
+        /**
+         * @brief yield coroutine and pass data to the caller
+         * @param priv_data private data, if not NULL, will get the value from start(priv_data) or resume(priv_data)
+         * @param yield_data data which will be received by start(priv_data, yield_data) of the caller
+         * @note yield_data is passed by pointer, nothing is copied
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int yield(void **priv_data, void *yield_data);
+
+        /**
+         * @brief unwind the stack of a suspended coroutine in one resume
+         * @param priv_data private data, will be passed to runner operator() or return to yield
+         * @note yield() inside the coroutine throws detail::forced_unwind, so destructors on the coroutine stack run and
+         *       the coroutine finishes without running the code after yield(). A coroutine which has not started yet will
+         *       finish without calling the runner.
+         *       If exceptions are disabled, this is the same as start(priv_data)
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int unwind(void *priv_data = UTIL_CONFIG_NULLPTR);
+
+        /**
+         * @brief check if this coroutine is being unwinded
+         * @return true if unwind() has been called
+         */
+        inline bool is_unwinding() const UTIL_CONFIG_NOEXCEPT { return 0 != (flags_ & flag_t::EN_CFT_UNWINDING); }
 
         /**
          * @brief set all flags to true
@@ -151,7 +217,7 @@ namespace copp {
          * @param flags flags to be checked
          * @return true if flags any flags is true
          */
-        bool check_flags(int flags) const;
+        inline bool check_flags(int flags) const UTIL_CONFIG_NOEXCEPT { return 0 != (flags_ & flags); }
 
     protected:
         /**
@@ -175,6 +241,27 @@ namespace copp {
         int set_runner(const callback_t &runner);
 #endif
 
+        /**
+         * @brief reinitialize an exited coroutine on the same stack, so it can be started again with a new runner
+         * @param runner new runner
+         * @note Nothing is allocated. The fcontext is made again below the coroutine object, coroutine-local values are
+         *       destroyed, and the return code and flags of the last run are cleared. The private buffer is kept as it is.
+         *       It can also be called on a coroutine which is created but not started.
+         * @return COPP_EC_SUCCESS or error code, COPP_EC_NOT_READY if the coroutine is suspended or running
+         */
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        int reset(callback_t &&runner);
+#else
+        int reset(const callback_t &runner);
+#endif
+
+        /**
+         * @brief reinitialize an exited coroutine on the same stack and keep the runner
+         * @see reset(runner)
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int restart();
+
         /**
          * get runner of this coroutine context (const)
          * @return NULL of pointer of runner
@@ -203,6 +290,30 @@ namespace copp {
          */
         inline size_t get_private_buffer_size() const UTIL_CONFIG_NOEXCEPT { return private_buffer_size_; }
 
+        /**
+         * @brief get value of coroutine-local slot
+         * @param index slot index allocated by detail::coroutine_local_alloc_slot
+         * @return value, or NULL if not set or index is invalid
+         */
+        inline void *get_local(size_t index) const UTIL_CONFIG_NOEXCEPT {
+            return index < COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER ? local_slots_[index] : UTIL_CONFIG_NULLPTR;
+        }
+
+        /**
+         * @brief set value of coroutine-local slot
+         * @param index slot index allocated by detail::coroutine_local_alloc_slot
+         * @param value new value, the old value is not destroyed
+         * @return COPP_EC_SUCCESS or COPP_EC_OUT_OF_RANGE
+         */
+        inline int set_local(size_t index, void *value) UTIL_CONFIG_NOEXCEPT {
+            if (index >= COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER) {
+                return COPP_EC_OUT_OF_RANGE;
+            }
+
+            local_slots_[index] = value;
+            return COPP_EC_SUCCESS;
+        }
+
     protected:
         /**
          * @brief call platform jump to asm instruction
@@ -220,6 +331,12 @@ namespace copp {
          */
         static void coroutine_context_callback(::copp::fcontext::transfer_t src_ctx);
 
+    private:
+        void destroy_local_slots() UTIL_CONFIG_NOEXCEPT;
+
+        // status is EN_CRS_INVALID after it returns
+        int reset_context() UTIL_CONFIG_NOEXCEPT;
+
     public:
         static inline size_t align_private_data_size(size_t sz) {
 // static size_t random_index = 0;
@@ -262,7 +379,11 @@ namespace copp {
          * @see detail::coroutine_context
          * @return pointer of current coroutine, if not in coroutine, return NULL
          */
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+        inline coroutine_context *get_coroutine() UTIL_CONFIG_NOEXCEPT { return detail::gt_current_coroutine; }
+#else
         coroutine_context *get_coroutine() UTIL_CONFIG_NOEXCEPT;
+#endif
 
         /**
          * @brief get current coroutine and try to convert type
@@ -275,6 +396,14 @@ namespace copp {
             return static_cast<Tc *>(get_coroutine());
         }
 
+        /**
+         * @brief set current coroutine of this thread without switching stack
+         * @note it's used to run code on the stack of caller as if it's not in any coroutine, the old one must be set back
+         * @param co new current coroutine, or NULL
+         * @return the old current coroutine
+         */
+        coroutine_context *exchange_coroutine(coroutine_context *co) UTIL_CONFIG_NOEXCEPT;
+
         /**
          * @brief yield current coroutine
          * @param priv_data private data, if not NULL, will get the value from start(priv_data) or resume(priv_data)
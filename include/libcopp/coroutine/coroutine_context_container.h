@@ -13,19 +13,22 @@
 #include <libcopp/stack/stack_allocator.h>
 #include <libcopp/stack/stack_traits.h>
 #include <libcopp/utils/errno.h>
+#include <libcopp/utils/thread_policy.h>
 
 namespace copp {
     /**
      * @brief coroutine container
      * contain stack context, stack allocator and runtime fcontext
+     * @note TThreadPolicy decides if the reference counter is atomic, see util::lock::single_thread_policy
      */
-    template <typename TALLOC>
+    template <typename TALLOC, typename TThreadPolicy = util::lock::default_thread_policy>
     class coroutine_context_container : public coroutine_context {
     public:
         typedef coroutine_context coroutine_context_type;
         typedef coroutine_context base_type;
         typedef TALLOC allocator_type;
-        typedef coroutine_context_container<allocator_type> this_type;
+        typedef TThreadPolicy thread_policy_t;
+        typedef coroutine_context_container<allocator_type, thread_policy_t> this_type;
         typedef std::intrusive_ptr<this_type> ptr_t;
         typedef coroutine_context::callback_t callback_t;
 
@@ -74,20 +77,53 @@ namespace copp {
                 stack_size = stack_traits::default_size();
             }
 
+            // padding to sizeof size_t
+            if (stack_size <= align_address_size(coroutine_size) + align_address_size(sizeof(this_type)) +
+                                  coroutine_context::align_private_data_size(private_buffer_size)) {
+                return ret;
+            }
+
+            stack_context callee_stack;
+            alloc.allocate(callee_stack, stack_size);
+
+            if (NULL == callee_stack.sp) {
+                return ret;
+            }
+
+            return create_on_stack(COPP_MACRO_STD_MOVE(runner), alloc, callee_stack, private_buffer_size, coroutine_size);
+        }
+
+        /**
+         * @brief create and init coroutine on a stack which is already allocated by alloc
+         * @param runner runner
+         * @param alloc allocator of callee_stack, it will be used to deallocate the stack
+         * @param callee_stack stack allocated by alloc, it's taken by the coroutine or deallocated on failure
+         * @param private_buffer_size private buffer size
+         * @param coroutine_size extend buffer before coroutine
+         * @return coroutine, or empty on failure
+         */
+        static ptr_t create_on_stack(
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+            callback_t &&runner,
+#else
+            const callback_t &runner,
+#endif
+            allocator_type &alloc, stack_context &callee_stack, size_t private_buffer_size = 0,
+            size_t coroutine_size = 0) UTIL_CONFIG_NOEXCEPT {
+            ptr_t ret;
+
             // padding to sizeof size_t
             coroutine_size = align_address_size(coroutine_size);
             const size_t this_align_size = align_address_size(sizeof(this_type));
             coroutine_size += this_align_size;
             private_buffer_size = coroutine_context::align_private_data_size(private_buffer_size);
 
-            if (stack_size <= coroutine_size + private_buffer_size) {
+            if (NULL == callee_stack.sp) {
                 return ret;
             }
 
-            stack_context callee_stack;
-            alloc.allocate(callee_stack, stack_size);
-
-            if (NULL == callee_stack.sp) {
+            if (callee_stack.size <= coroutine_size + private_buffer_size) {
+                alloc.deallocate(callee_stack);
                 return ret;
             }
 
@@ -194,11 +230,7 @@ namespace copp {
 
     private:
         allocator_type alloc_; /** stack allocator **/
-#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
-        util::lock::atomic_int_type<util::lock::unsafe_int_type<size_t> > ref_count_; /** status **/
-#else
-        util::lock::atomic_int_type<size_t> ref_count_; /** status **/
-#endif
+        typename thread_policy_t::template atomic_type<size_t>::type ref_count_; /** status **/
     };
 
     typedef coroutine_context_container<allocator::default_statck_allocator> coroutine_context_default;
@@ -0,0 +1,106 @@
+/*
+ * coroutine_local.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COPP_COROUTINE_COROUTINE_LOCAL_H
+#define COPP_COROUTINE_COROUTINE_LOCAL_H
+
+#pragma once
+
+#include <cstddef>
+
+#include <libcopp/coroutine/coroutine_context.h>
+#include <libcopp/utils/errno.h>
+#include <libcopp/utils/non_copyable.h>
+
+namespace copp {
+    /**
+     * @brief coroutine-local pointer, like thread_specific_ptr but for coroutines
+     * @note Every coroutine_local_ptr takes one of the COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER slots when it's constructed
+     *       and never releases it, so it should be a global or static object.
+     *       get() is a TLS read of current coroutine and an indexed load from the slots in coroutine_context.
+     *       The destructor is called with the value when a coroutine is destroyed, in the thread which destroys it.
+     */
+    template <typename T>
+    class coroutine_local_ptr : utils::non_copyable {
+    public:
+        typedef T value_type;
+        typedef void (*destructor_t)(void *);
+
+        /**
+         * @param destructor called with the value when the coroutine is destroyed, NULL means do nothing,
+         *        use coroutine_local_ptr<T>::delete_value to delete it
+         */
+        explicit coroutine_local_ptr(destructor_t destructor = UTIL_CONFIG_NULLPTR) {
+            int res = detail::coroutine_local_alloc_slot(destructor);
+            // invalid index makes get() returns NULL and set() returns COPP_EC_OUT_OF_RANGE
+            index_ = res < 0 ? static_cast<size_t>(COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER) : static_cast<size_t>(res);
+        }
+
+        /**
+         * @brief check if slot is allocated
+         * @return false if all slots are used
+         */
+        inline bool valid() const UTIL_CONFIG_NOEXCEPT { return index_ < COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER; }
+
+        inline size_t get_index() const UTIL_CONFIG_NOEXCEPT { return index_; }
+
+        /**
+         * @brief get value of current coroutine
+         * @return value or NULL if not in coroutine or not set
+         */
+        inline value_type *get() const UTIL_CONFIG_NOEXCEPT {
+            coroutine_context *co = this_coroutine::get_coroutine();
+            if (UTIL_CONFIG_NULLPTR == co) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            return reinterpret_cast<value_type *>(co->get_local(index_));
+        }
+
+        /**
+         * @brief get value of the specify coroutine
+         * @return value or NULL if not set
+         */
+        inline value_type *get(const coroutine_context &co) const UTIL_CONFIG_NOEXCEPT {
+            return reinterpret_cast<value_type *>(co.get_local(index_));
+        }
+
+        /**
+         * @brief set value of current coroutine, the old value is not destroyed
+         * @return COPP_EC_SUCCESS or error code
+         */
+        inline int set(value_type *value) UTIL_CONFIG_NOEXCEPT {
+            coroutine_context *co = this_coroutine::get_coroutine();
+            if (UTIL_CONFIG_NULLPTR == co) {
+                return COPP_EC_NOT_RUNNING;
+            }
+
+            return co->set_local(index_, value);
+        }
+
+        /**
+         * @brief set value of the specify coroutine, the old value is not destroyed
+         * @return COPP_EC_SUCCESS or error code
+         */
+        inline int set(coroutine_context &co, value_type *value) UTIL_CONFIG_NOEXCEPT { return co.set_local(index_, value); }
+
+        inline value_type *operator->() const UTIL_CONFIG_NOEXCEPT { return get(); }
+        inline value_type &operator*() const UTIL_CONFIG_NOEXCEPT { return *get(); }
+
+        /**
+         * @brief destructor which deletes the value
+         */
+        static void delete_value(void *value) { delete reinterpret_cast<value_type *>(value); }
+
+    private:
+        size_t index_;
+    };
+} // namespace copp
+
+#endif
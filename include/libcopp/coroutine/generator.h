@@ -0,0 +1,232 @@
+/*
+ * generator.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COPP_COROUTINE_GENERATOR_H
+#define COPP_COROUTINE_GENERATOR_H
+
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+#include <libcopp/coroutine/coroutine_context_container.h>
+#include <libcopp/utils/errno.h>
+#include <libcopp/utils/non_copyable.h>
+#include <libcopp/utils/std/functional.h>
+
+namespace copp {
+    namespace detail {
+        /**
+         * @brief input iterator over the values of a generator or push_coroutine::pull_type
+         * @note TOwner must have valid(), get() and next()
+         */
+        template <typename TOwner, typename T>
+        class generator_iterator {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T *pointer;
+            typedef const T &reference;
+
+            generator_iterator() UTIL_CONFIG_NOEXCEPT : owner_(UTIL_CONFIG_NULLPTR) {}
+            explicit generator_iterator(TOwner *owner) UTIL_CONFIG_NOEXCEPT : owner_(owner) {
+                if (UTIL_CONFIG_NULLPTR != owner_ && !owner_->valid()) {
+                    owner_ = UTIL_CONFIG_NULLPTR;
+                }
+            }
+
+            inline reference operator*() const { return owner_->get(); }
+            inline pointer operator->() const { return &owner_->get(); }
+
+            inline generator_iterator &operator++() {
+                owner_->next();
+                if (!owner_->valid()) {
+                    owner_ = UTIL_CONFIG_NULLPTR;
+                }
+                return *this;
+            }
+
+            inline void operator++(int) { ++(*this); }
+
+            inline bool operator==(const generator_iterator &other) const UTIL_CONFIG_NOEXCEPT { return owner_ == other.owner_; }
+            inline bool operator!=(const generator_iterator &other) const UTIL_CONFIG_NOEXCEPT { return owner_ != other.owner_; }
+
+        private:
+            TOwner *owner_;
+        };
+    } // namespace detail
+
+    /**
+     * @brief pull style generator, the body produces values by yield_type and the owner consumes them by next()/get()
+     * @note values are passed by pointer through start(priv_data, yield_data)/yield(priv_data, yield_data), nothing is
+     *       copied and nothing is allocated per value. The value passed to yield_type is alive until next() is called.
+     *       The body is any callable of void(yield_type &), it's moved into the private buffer of the coroutine, so
+     *       nothing but the coroutine stack is allocated.
+     *       The body is started in the constructor and runs to the first value.
+     *       If the generator is destroyed before the body returns, the stack of the body is unwinded, so destructors of
+     *       objects on it are called. Without exception support it can not be unwinded and those destructors never run,
+     *       so the body must return before the generator is destroyed, it's asserted in debug builds.
+     */
+    template <typename T, typename TALLOC = allocator::default_statck_allocator>
+    class generator : utils::non_copyable {
+    public:
+        typedef T value_type;
+        typedef TALLOC allocator_type;
+        typedef coroutine_context_container<allocator_type> coroutine_type;
+        typedef typename coroutine_type::ptr_t coroutine_ptr_t;
+        typedef generator<value_type, allocator_type> this_type;
+        typedef detail::generator_iterator<this_type, value_type> iterator;
+
+        /**
+         * @brief yield side of generator, passed to the body
+         */
+        class yield_type {
+        public:
+            /**
+             * @brief pass a value to the consumer and suspend until the next value is requested
+             * @param v value, it must be alive until this call returns
+             * @return COPP_EC_SUCCESS or error code
+             */
+            inline int operator()(const value_type &v) {
+                return co_->yield(UTIL_CONFIG_NULLPTR, const_cast<void *>(reinterpret_cast<const void *>(&v)));
+            }
+
+        private:
+            friend class generator;
+            coroutine_context *co_;
+        };
+
+    private:
+        // placed in the private buffer of the coroutine, so it does not move with the generator
+        template <typename TBody>
+        struct context_t {
+            template <typename TArg>
+            explicit context_t(TArg &&b) : body(COPP_MACRO_STD_FORWARD(TArg, b)) {}
+
+            TBody body;
+        };
+
+    public:
+        template <typename TBody>
+        explicit generator(TBody &&body, size_t stack_size = 0) : current_(UTIL_CONFIG_NULLPTR), destroy_fn_(UTIL_CONFIG_NULLPTR) {
+            allocator_type alloc;
+            init(COPP_MACRO_STD_FORWARD(TBody, body), alloc, stack_size);
+        }
+
+        template <typename TBody>
+        generator(TBody &&body, allocator_type &alloc, size_t stack_size = 0)
+            : current_(UTIL_CONFIG_NULLPTR), destroy_fn_(UTIL_CONFIG_NULLPTR) {
+            init(COPP_MACRO_STD_FORWARD(TBody, body), alloc, stack_size);
+        }
+
+        ~generator() {
+            if (!co_) {
+                return;
+            }
+
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+            // destroy objects on the stack of the body
+            if (!co_->is_finished()) {
+                co_->unwind();
+            }
+#else
+            // objects on the stack of an unfinished body would never be destroyed
+            assert(co_->is_finished());
+#endif
+            if (UTIL_CONFIG_NULLPTR != destroy_fn_) {
+                (*destroy_fn_)(co_->get_private_buffer());
+            }
+        }
+
+        /**
+         * @brief check if there is a value available
+         * @return true if get() can be called
+         */
+        inline bool valid() const UTIL_CONFIG_NOEXCEPT { return UTIL_CONFIG_NULLPTR != current_; }
+
+        /**
+         * @brief get current value
+         * @note valid() must be true
+         * @return current value, which is owned by the body
+         */
+        inline const value_type &get() const UTIL_CONFIG_NOEXCEPT { return *current_; }
+
+        /**
+         * @brief resume the body to get the next value
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int next() {
+            if (!co_ || co_->is_finished()) {
+                current_ = UTIL_CONFIG_NULLPTR;
+                return COPP_EC_ALREADY_FINISHED;
+            }
+
+            return resume(UTIL_CONFIG_NULLPTR);
+        }
+
+        inline iterator begin() { return iterator(this); }
+        inline iterator end() { return iterator(); }
+
+        /**
+         * @brief get the coroutine which runs the body
+         * @return coroutine, empty if failed to create it
+         */
+        inline const coroutine_ptr_t &get_coroutine() const UTIL_CONFIG_NOEXCEPT { return co_; }
+
+    private:
+        template <typename TBody>
+        void init(TBody &&body, allocator_type &alloc, size_t stack_size) {
+            typedef context_t<typename std::decay<TBody>::type> ctx_t;
+
+            co_ = coroutine_type::create(&generator::runner<ctx_t>, alloc, stack_size, sizeof(ctx_t));
+            if (!co_) {
+                return;
+            }
+
+            ctx_t *ctx  = new (co_->get_private_buffer()) ctx_t(COPP_MACRO_STD_FORWARD(TBody, body));
+            destroy_fn_ = &generator::destroy<ctx_t>;
+
+            // run to the first value
+            resume(ctx);
+        }
+
+        inline int resume(void *priv_data) {
+            void *yield_data = UTIL_CONFIG_NULLPTR;
+            int ret = co_->start(priv_data, &yield_data);
+            // NULL when the body returns
+            current_ = reinterpret_cast<const value_type *>(yield_data);
+            return ret;
+        }
+
+        template <typename TCtx>
+        static int runner(void *priv_data) {
+            TCtx *ctx = reinterpret_cast<TCtx *>(priv_data);
+            yield_type yield;
+            yield.co_ = this_coroutine::get_coroutine();
+            ctx->body(yield);
+            return 0;
+        }
+
+        template <typename TCtx>
+        static void destroy(void *ctx) {
+            reinterpret_cast<TCtx *>(ctx)->~TCtx();
+        }
+
+    private:
+        coroutine_ptr_t co_;
+        const value_type *current_;
+        void (*destroy_fn_)(void *);
+    };
+} // namespace copp
+
+#endif
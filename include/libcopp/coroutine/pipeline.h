@@ -0,0 +1,317 @@
+/*
+ * pipeline.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COPP_COROUTINE_PIPELINE_H
+#define COPP_COROUTINE_PIPELINE_H
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <libcopp/coroutine/coroutine_context_container.h>
+#include <libcopp/utils/errno.h>
+#include <libcopp/utils/non_copyable.h>
+
+namespace copp {
+    namespace detail {
+        /**
+         * @brief type independent part of pipeline_channel, which is passed to the pipeline when a stage is blocked
+         */
+        class pipeline_channel_base : utils::non_copyable {
+        public:
+            /**
+             * @brief changed by every push, pop and close, a blocked stage can not continue until it's changed
+             */
+            inline size_t get_version() const UTIL_CONFIG_NOEXCEPT { return head_ + tail_ + (closed_ ? 1 : 0); }
+
+        protected:
+            pipeline_channel_base() : head_(0), tail_(0), closed_(false) {}
+
+            // let the other stages run, and tell the pipeline which channel this stage is waiting for
+            inline int wait() {
+                coroutine_context *co = this_coroutine::get_coroutine();
+                if (UTIL_CONFIG_NULLPTR == co) {
+                    return COPP_EC_NOT_RUNNING;
+                }
+
+                return co->yield(UTIL_CONFIG_NULLPTR, this);
+            }
+
+        protected:
+            size_t head_;
+            size_t tail_;
+            bool closed_;
+        };
+    } // namespace detail
+
+    /**
+     * @brief fixed-capacity ring buffer between two stages of a pipeline
+     * @note A stage only yields when the channel is full (writer) or empty (reader), so the capacity is the batch size:
+     *       each switch moves up to capacity items. Writers are blocked when it's full, which is the backpressure.
+     *       It's for coroutines in one thread, there is no lock.
+     */
+    template <typename T>
+    class pipeline_channel : public detail::pipeline_channel_base {
+    public:
+        typedef T value_type;
+
+        /**
+         * @param capacity max number of items in channel, rounded up to power of 2
+         */
+        explicit pipeline_channel(size_t capacity) {
+            size_t real_capacity = 1;
+            while (real_capacity < capacity) {
+                real_capacity <<= 1;
+            }
+            buffer_.resize(real_capacity);
+            mask_ = real_capacity - 1;
+        }
+
+        inline size_t capacity() const UTIL_CONFIG_NOEXCEPT { return mask_ + 1; }
+        inline size_t size() const UTIL_CONFIG_NOEXCEPT { return tail_ - head_; }
+        inline bool empty() const UTIL_CONFIG_NOEXCEPT { return tail_ == head_; }
+        inline bool full() const UTIL_CONFIG_NOEXCEPT { return size() > mask_; }
+
+        /**
+         * @brief mark there will be no more items, readers get COPP_EC_ALREADY_FINISHED after the remaining items
+         * @note a reader which stops early should also close it, so blocked writers get COPP_EC_ALREADY_FINISHED
+         */
+        inline void close() UTIL_CONFIG_NOEXCEPT { closed_ = true; }
+        inline bool is_closed() const UTIL_CONFIG_NOEXCEPT { return closed_; }
+
+        // ---------------- item API ----------------
+        inline bool try_push(const value_type &v) {
+            if (full() || closed_) {
+                return false;
+            }
+
+            buffer_[tail_ & mask_] = v;
+            ++tail_;
+            return true;
+        }
+
+        inline bool try_pop(value_type &out) {
+            if (empty()) {
+                return false;
+            }
+
+            out = buffer_[head_ & mask_];
+            ++head_;
+            return true;
+        }
+
+        /**
+         * @brief push an item, yield current coroutine while channel is full
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int push(const value_type &v) {
+            while (full() && !closed_) {
+                int res = wait();
+                if (res < 0) {
+                    return res;
+                }
+            }
+
+            if (closed_) {
+                return COPP_EC_ALREADY_FINISHED;
+            }
+
+            buffer_[tail_ & mask_] = v;
+            ++tail_;
+            return COPP_EC_SUCCESS;
+        }
+
+        /**
+         * @brief pop an item, yield current coroutine while channel is empty
+         * @return COPP_EC_SUCCESS, COPP_EC_ALREADY_FINISHED if channel is closed and empty, or other error code
+         */
+        int pop(value_type &out) {
+            while (empty()) {
+                if (closed_) {
+                    return COPP_EC_ALREADY_FINISHED;
+                }
+
+                int res = wait();
+                if (res < 0) {
+                    return res;
+                }
+            }
+
+            out = buffer_[head_ & mask_];
+            ++head_;
+            return COPP_EC_SUCCESS;
+        }
+
+        // ---------------- span API, no copy out of the ring buffer ----------------
+        /**
+         * @brief get contiguous free space, yield current coroutine while channel is full
+         * @param out set to the first writable item
+         * @return number of writable items, 0 if channel is closed or failed to yield
+         */
+        size_t acquire_write(value_type *&out) {
+            while (full() && !closed_) {
+                if (wait() < 0) {
+                    return 0;
+                }
+            }
+
+            if (closed_) {
+                return 0;
+            }
+
+            size_t start = tail_ & mask_;
+            size_t n = capacity() - size();
+            if (start + n > capacity()) {
+                n = capacity() - start;
+            }
+            out = &buffer_[start];
+            return n;
+        }
+
+        /**
+         * @brief publish n items written into the span got by acquire_write
+         */
+        inline void commit_write(size_t n) UTIL_CONFIG_NOEXCEPT { tail_ += n; }
+
+        /**
+         * @brief get contiguous readable items, yield current coroutine while channel is empty
+         * @param out set to the first readable item
+         * @return number of readable items, 0 if channel is closed and empty or failed to yield
+         */
+        size_t acquire_read(value_type *&out) {
+            while (empty()) {
+                if (closed_ || wait() < 0) {
+                    return 0;
+                }
+            }
+
+            size_t start = head_ & mask_;
+            size_t n = size();
+            if (start + n > capacity()) {
+                n = capacity() - start;
+            }
+            out = &buffer_[start];
+            return n;
+        }
+
+        /**
+         * @brief release n items got by acquire_read
+         */
+        inline void commit_read(size_t n) UTIL_CONFIG_NOEXCEPT { head_ += n; }
+
+    private:
+        std::vector<value_type> buffer_;
+        size_t mask_;
+    };
+
+    /**
+     * @brief run stages connected by pipeline_channel in coroutines
+     * @note Stages are resumed round-robin in the order they are added, a stage yields when it's blocked by a channel.
+     *       Every stage must close its output channels before it returns. If all the unfinished stages are blocked
+     *       by channels which are not changed in a whole round, none of them can continue, run() returns
+     *       COPP_EC_DEADLOCK and leaves them suspended.
+     */
+    template <typename TALLOC = allocator::default_statck_allocator>
+    class pipeline : utils::non_copyable {
+    public:
+        typedef TALLOC allocator_type;
+        typedef coroutine_context_container<allocator_type> coroutine_type;
+        typedef typename coroutine_type::ptr_t coroutine_ptr_t;
+        typedef typename coroutine_type::callback_t callback_t;
+
+        /**
+         * @brief add a stage
+         * @param runner stage runner
+         * @param stack_size stack size of the stage
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int add_stage(callback_t runner, size_t stack_size = 0) {
+            allocator_type alloc;
+            return add_stage(COPP_MACRO_STD_MOVE(runner), alloc, stack_size);
+        }
+
+        int add_stage(callback_t runner, allocator_type &alloc, size_t stack_size = 0) {
+            coroutine_ptr_t co = coroutine_type::create(COPP_MACRO_STD_MOVE(runner), alloc, stack_size);
+            if (!co) {
+                return COPP_EC_ALLOC_STACK_FAILED;
+            }
+
+            stages_.push_back(co);
+            return COPP_EC_SUCCESS;
+        }
+
+        inline size_t size() const UTIL_CONFIG_NOEXCEPT { return stages_.size(); }
+
+        /**
+         * @brief run until all stages finished
+         * @return COPP_EC_SUCCESS, COPP_EC_DEADLOCK if no stage can continue, or other error code
+         */
+        int run() {
+            // the channel and its version when each stage is blocked, channel is NULL if the stage yields by itself
+            std::vector<wait_state_t> waits(stages_.size());
+            bool running = true;
+            while (running) {
+                running = false;
+                for (size_t i = 0; i < stages_.size(); ++i) {
+                    if (stages_[i]->is_finished()) {
+                        continue;
+                    }
+
+                    running = true;
+                    void *yield_data = UTIL_CONFIG_NULLPTR;
+                    int res = stages_[i]->start(UTIL_CONFIG_NULLPTR, &yield_data);
+                    if (res < 0) {
+                        return res;
+                    }
+
+                    waits[i].channel = reinterpret_cast<const detail::pipeline_channel_base *>(yield_data);
+                    if (UTIL_CONFIG_NULLPTR != waits[i].channel) {
+                        waits[i].version = waits[i].channel->get_version();
+                    }
+                }
+
+                if (running && is_deadlock(waits)) {
+                    return COPP_EC_DEADLOCK;
+                }
+            }
+
+            return COPP_EC_SUCCESS;
+        }
+
+    private:
+        struct wait_state_t {
+            const detail::pipeline_channel_base *channel;
+            size_t version;
+
+            wait_state_t() : channel(UTIL_CONFIG_NULLPTR), version(0) {}
+        };
+
+        bool is_deadlock(const std::vector<wait_state_t> &waits) const {
+            bool has_blocked = false;
+            for (size_t i = 0; i < stages_.size(); ++i) {
+                if (stages_[i]->is_finished()) {
+                    continue;
+                }
+
+                if (UTIL_CONFIG_NULLPTR == waits[i].channel || waits[i].channel->get_version() != waits[i].version) {
+                    return false;
+                }
+                has_blocked = true;
+            }
+
+            return has_blocked;
+        }
+
+    private:
+        std::vector<coroutine_ptr_t> stages_;
+    };
+} // namespace copp
+
+#endif
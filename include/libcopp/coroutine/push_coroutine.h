@@ -0,0 +1,205 @@
+/*
+ * push_coroutine.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COPP_COROUTINE_PUSH_COROUTINE_H
+#define COPP_COROUTINE_PUSH_COROUTINE_H
+
+#pragma once
+
+#include <libcopp/coroutine/generator.h>
+
+namespace copp {
+    /**
+     * @brief push style coroutine, the owner produces values by push() and the body consumes them by pull_type
+     * @note values are passed by pointer through start(priv_data)/yield(priv_data), nothing is copied and nothing is
+     *       allocated per value. The value passed to push() is alive until push() returns, so the body must not keep
+     *       pointers to it after requesting the next value.
+     *       The body is any callable of void(pull_type &), it's moved into the private buffer of the coroutine, so
+     *       nothing but the coroutine stack is allocated.
+     *       The body is called when the first value is pushed, and it should return when pull_type::valid() is false.
+     *       If the body does not return after it's closed by the destructor, the stack of the body is unwinded, so
+     *       destructors of objects on it are called. Without exception support it can not be unwinded and those
+     *       destructors never run, so the body must return after closed, it's asserted in debug builds.
+     */
+    template <typename T, typename TALLOC = allocator::default_statck_allocator>
+    class push_coroutine : utils::non_copyable {
+    public:
+        typedef T value_type;
+        typedef TALLOC allocator_type;
+        typedef coroutine_context_container<allocator_type> coroutine_type;
+        typedef typename coroutine_type::ptr_t coroutine_ptr_t;
+
+        /**
+         * @brief pull side of push_coroutine, passed to the body
+         */
+        class pull_type {
+        public:
+            typedef detail::generator_iterator<pull_type, value_type> iterator;
+
+            /**
+             * @brief check if there is a value available
+             * @return false after push_coroutine is closed
+             */
+            inline bool valid() const UTIL_CONFIG_NOEXCEPT { return UTIL_CONFIG_NULLPTR != current_; }
+
+            /**
+             * @brief get current value
+             * @note valid() must be true
+             * @return current value, which is owned by the caller of push()
+             */
+            inline const value_type &get() const UTIL_CONFIG_NOEXCEPT { return *current_; }
+
+            /**
+             * @brief suspend until the next value is pushed
+             * @return COPP_EC_SUCCESS or error code
+             */
+            int next() {
+                void *priv_data = UTIL_CONFIG_NULLPTR;
+                int ret = co_->yield(&priv_data);
+                // NULL when push_coroutine is closed
+                current_ = reinterpret_cast<const value_type *>(priv_data);
+                return ret;
+            }
+
+            inline int operator()() { return next(); }
+
+            inline iterator begin() { return iterator(this); }
+            inline iterator end() { return iterator(); }
+
+        private:
+            friend class push_coroutine;
+            coroutine_context *co_;
+            const value_type *current_;
+        };
+
+    private:
+        // placed in the private buffer of the coroutine, so it does not move with the push_coroutine
+        template <typename TBody>
+        struct context_t {
+            template <typename TArg>
+            explicit context_t(TArg &&b) : body(COPP_MACRO_STD_FORWARD(TArg, b)) {}
+
+            TBody body;
+        };
+
+    public:
+        template <typename TBody>
+        explicit push_coroutine(TBody &&body, size_t stack_size = 0) : destroy_fn_(UTIL_CONFIG_NULLPTR) {
+            allocator_type alloc;
+            init(COPP_MACRO_STD_FORWARD(TBody, body), alloc, stack_size);
+        }
+
+        template <typename TBody>
+        push_coroutine(TBody &&body, allocator_type &alloc, size_t stack_size = 0) : destroy_fn_(UTIL_CONFIG_NULLPTR) {
+            init(COPP_MACRO_STD_FORWARD(TBody, body), alloc, stack_size);
+        }
+
+        ~push_coroutine() {
+            if (!co_) {
+                return;
+            }
+
+            close();
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+            // the body does not return after closed, destroy objects on its stack
+            if (!co_->is_finished()) {
+                co_->unwind();
+            }
+#else
+            // objects on the stack of an unfinished body would never be destroyed
+            assert(co_->is_finished());
+#endif
+            if (UTIL_CONFIG_NULLPTR != destroy_fn_) {
+                (*destroy_fn_)(co_->get_private_buffer());
+            }
+        }
+
+        /**
+         * @brief check if the body can receive values
+         * @return false if the body has returned
+         */
+        inline bool valid() const UTIL_CONFIG_NOEXCEPT { return co_ && !co_->is_finished(); }
+
+        /**
+         * @brief pass a value to the body and run it until it requests the next value
+         * @param v value, it must be alive until this call returns
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int push(const value_type &v) {
+            if (!valid()) {
+                return COPP_EC_ALREADY_FINISHED;
+            }
+
+            return co_->start(const_cast<void *>(reinterpret_cast<const void *>(&v)));
+        }
+
+        inline int operator()(const value_type &v) { return push(v); }
+
+        /**
+         * @brief tell the body there is no more value, pull_type::valid() will be false in the body
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int close() {
+            if (!valid()) {
+                return COPP_EC_ALREADY_FINISHED;
+            }
+
+            return co_->start(UTIL_CONFIG_NULLPTR);
+        }
+
+        /**
+         * @brief get the coroutine which runs the body
+         * @return coroutine, empty if failed to create it
+         */
+        inline const coroutine_ptr_t &get_coroutine() const UTIL_CONFIG_NOEXCEPT { return co_; }
+
+    private:
+        template <typename TBody>
+        void init(TBody &&body, allocator_type &alloc, size_t stack_size) {
+            typedef context_t<typename std::decay<TBody>::type> ctx_t;
+
+            co_ = coroutine_type::create(&push_coroutine::runner<ctx_t>, alloc, stack_size, sizeof(ctx_t));
+            if (!co_) {
+                return;
+            }
+
+            ctx_t *ctx  = new (co_->get_private_buffer()) ctx_t(COPP_MACRO_STD_FORWARD(TBody, body));
+            destroy_fn_ = &push_coroutine::destroy<ctx_t>;
+
+            // run to the point waiting for the first value
+            co_->start(ctx);
+        }
+
+        template <typename TCtx>
+        static int runner(void *priv_data) {
+            TCtx *ctx = reinterpret_cast<TCtx *>(priv_data);
+            pull_type source;
+            source.co_ = this_coroutine::get_coroutine();
+            source.current_ = UTIL_CONFIG_NULLPTR;
+
+            // wait for the first value, closed without any value will not call the body
+            source.next();
+            if (source.valid()) {
+                ctx->body(source);
+            }
+            return 0;
+        }
+
+        template <typename TCtx>
+        static void destroy(void *ctx) {
+            reinterpret_cast<TCtx *>(ctx)->~TCtx();
+        }
+
+    private:
+        coroutine_ptr_t co_;
+        void (*destroy_fn_)(void *);
+    };
+} // namespace copp
+
+#endif
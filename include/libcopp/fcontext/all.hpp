@@ -8,5 +8,7 @@
 #define _COPP_BOOST_CONTEXT_ALL_H
 
 #include "libcopp/fcontext/fcontext.hpp"
+#include "libcopp/fcontext/backend.hpp"
+#include "libcopp/fcontext/jump_inline.hpp"
 
 #endif // _COPP_BOOST_CONTEXT_ALL_H
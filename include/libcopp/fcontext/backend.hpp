@@ -0,0 +1,91 @@
+/*
+ * backend.hpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COPP_FCONTEXT_BACKEND_HPP
+#define COPP_FCONTEXT_BACKEND_HPP
+
+#pragma once
+
+#include "libcopp/fcontext/fcontext.hpp"
+
+// swapcontext/makecontext, it's slow because every switch calls sigprocmask, but it's useful as a baseline or fallback
+#if !defined(_WIN32) && !defined(__CYGWIN__) && !defined(__APPLE__) && !defined(__ANDROID__) && \
+    !defined(COPP_MACRO_USE_SEGMENTED_STACKS)
+#define COPP_FCONTEXT_HAS_UCONTEXT_BACKEND 1
+#endif
+
+// hand-rolled push/pop switch, without floating point control words
+#if (defined(__x86_64__) || defined(__amd64__)) && defined(__GNUC__) && defined(__ELF__) && !defined(_WIN32) && \
+    !defined(__CYGWIN__) && !defined(COPP_MACRO_USE_SEGMENTED_STACKS)
+#define COPP_FCONTEXT_HAS_MINIMAL_BACKEND 1
+#endif
+
+namespace copp {
+    namespace fcontext {
+#if defined(COPP_FCONTEXT_HAS_UCONTEXT_BACKEND) && COPP_FCONTEXT_HAS_UCONTEXT_BACKEND
+        extern "C" transfer_t copp_jump_fcontext_ucontext(fcontext_t const to, void *vp);
+        extern "C" fcontext_t copp_make_fcontext_ucontext(void *sp, std::size_t size, void (*fn)(transfer_t));
+#endif
+
+#if defined(COPP_FCONTEXT_HAS_MINIMAL_BACKEND) && COPP_FCONTEXT_HAS_MINIMAL_BACKEND
+        extern "C" transfer_t copp_jump_fcontext_minimal(fcontext_t const to, void *vp);
+        extern "C" fcontext_t copp_make_fcontext_minimal(void *sp, std::size_t size, void (*fn)(transfer_t));
+#endif
+
+        /**
+         * @brief context switch backends, all of them have the same interface as copp_make_fcontext and copp_jump_fcontext
+         * @note contexts made by one backend can only be jumped by the same backend
+         */
+        struct backend_fcontext {
+            static inline const char *name() UTIL_CONFIG_NOEXCEPT { return "fcontext"; }
+
+            static inline fcontext_t make(void *sp, std::size_t size, void (*fn)(transfer_t)) {
+                return copp_make_fcontext(sp, size, fn);
+            }
+
+            static inline transfer_t jump(fcontext_t const to, void *vp) { return copp_jump_fcontext(to, vp); }
+        };
+
+#if defined(COPP_FCONTEXT_HAS_UCONTEXT_BACKEND) && COPP_FCONTEXT_HAS_UCONTEXT_BACKEND
+        struct backend_ucontext {
+            static inline const char *name() UTIL_CONFIG_NOEXCEPT { return "ucontext"; }
+
+            static inline fcontext_t make(void *sp, std::size_t size, void (*fn)(transfer_t)) {
+                return copp_make_fcontext_ucontext(sp, size, fn);
+            }
+
+            static inline transfer_t jump(fcontext_t const to, void *vp) { return copp_jump_fcontext_ucontext(to, vp); }
+        };
+#endif
+
+#if defined(COPP_FCONTEXT_HAS_MINIMAL_BACKEND) && COPP_FCONTEXT_HAS_MINIMAL_BACKEND
+        struct backend_minimal {
+            static inline const char *name() UTIL_CONFIG_NOEXCEPT { return "minimal"; }
+
+            static inline fcontext_t make(void *sp, std::size_t size, void (*fn)(transfer_t)) {
+                return copp_make_fcontext_minimal(sp, size, fn);
+            }
+
+            static inline transfer_t jump(fcontext_t const to, void *vp) { return copp_jump_fcontext_minimal(to, vp); }
+        };
+#endif
+
+        // backend used by coroutine_context, chosen by LIBCOPP_FCONTEXT_BACKEND
+#if defined(COPP_FCONTEXT_BACKEND_UCONTEXT) && defined(COPP_FCONTEXT_HAS_UCONTEXT_BACKEND)
+        typedef backend_ucontext backend_t;
+#elif defined(COPP_FCONTEXT_BACKEND_MINIMAL) && defined(COPP_FCONTEXT_HAS_MINIMAL_BACKEND)
+        typedef backend_minimal backend_t;
+#else
+        typedef backend_fcontext backend_t;
+#define COPP_FCONTEXT_BACKEND_IS_FCONTEXT 1
+#endif
+    } // namespace fcontext
+} // namespace copp
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * jump_inline.hpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COPP_FCONTEXT_JUMP_INLINE_HPP
+#define COPP_FCONTEXT_JUMP_INLINE_HPP
+
+#pragma once
+
+#include "libcopp/fcontext/fcontext.hpp"
+
+// inline switch is only available for x86_64 System V with GCC compatible inline asm
+#if (defined(__x86_64__) || defined(__amd64__)) && defined(__GNUC__) && !defined(_WIN32) && !defined(__CYGWIN__) && \
+    !defined(COPP_MACRO_USE_SEGMENTED_STACKS)
+#define COPP_FCONTEXT_HAS_INLINE_JUMP 1
+#endif
+
+#if defined(COPP_FCONTEXT_HAS_INLINE_JUMP) && COPP_FCONTEXT_HAS_INLINE_JUMP
+
+#if defined(COPP_FCONTEXT_USE_TSX) || defined(COPP_FCONTEXT_NO_FPU_CONTROL)
+#define COPP_FCONTEXT_INLINE_JUMP_SAVE_FPU ""
+#define COPP_FCONTEXT_INLINE_JUMP_LOAD_FPU ""
+#else
+#define COPP_FCONTEXT_INLINE_JUMP_SAVE_FPU \
+    "stmxcsr (%%rsp)\n\t"                  \
+    "fnstcw 0x4(%%rsp)\n\t"
+#define COPP_FCONTEXT_INLINE_JUMP_LOAD_FPU \
+    "ldmxcsr (%%rsp)\n\t"                  \
+    "fldcw 0x4(%%rsp)\n\t"
+#endif
+
+#if defined(__AVX512F__)
+// mask registers may also be kept live across the switch, and they are not saved by the other context
+#define COPP_FCONTEXT_INLINE_JUMP_CLOBBER_AVX512                                                                                 \
+    , "xmm16", "xmm17", "xmm18", "xmm19", "xmm20", "xmm21", "xmm22", "xmm23", "xmm24", "xmm25", "xmm26", "xmm27", "xmm28", "xmm29", \
+        "xmm30", "xmm31", "k0", "k1", "k2", "k3", "k4", "k5", "k6", "k7"
+#else
+#define COPP_FCONTEXT_INLINE_JUMP_CLOBBER_AVX512
+#endif
+
+namespace copp {
+    namespace fcontext {
+        /**
+         * @brief jump to another context by inline asm
+         * @note It use the same context-data layout as copp_jump_fcontext, so contexts created by copp_make_fcontext or
+         *       suspended by copp_jump_fcontext can be resumed by this function and vice versa.
+         *       Only RBP, return address(and floating point control words) are stored, other callee-saved registers are
+         *       declared as clobbered, so the compiler only spills what is live at the call site.
+         * @param to context to jump to
+         * @param vp data passed to the target context
+         * @return transfer_t of the context which jumps back
+         */
+        static inline __attribute__((always_inline)) transfer_t copp_jump_fcontext_inline(fcontext_t to, void *vp) {
+            transfer_t ret;
+            __asm__ __volatile__(
+                // skip the red zone and reserve space for context-data
+                "leaq -0xc0(%%rsp), %%rsp\n\t" COPP_FCONTEXT_INLINE_JUMP_SAVE_FPU
+                "movq %%rbp, 0x30(%%rsp)\n\t"
+                // resume at label 1
+                "leaq 1f(%%rip), %%rax\n\t"
+                "movq %%rax, 0x38(%%rsp)\n\t"
+                "movq %%rsp, %%rax\n\t"
+                // switch to the target context-data
+                "movq %%rdi, %%rsp\n\t"
+                "movq 0x38(%%rsp), %%r8\n\t" COPP_FCONTEXT_INLINE_JUMP_LOAD_FPU
+                "movq 0x8(%%rsp), %%r12\n\t"
+                "movq 0x10(%%rsp), %%r13\n\t"
+                "movq 0x18(%%rsp), %%r14\n\t"
+                "movq 0x20(%%rsp), %%r15\n\t"
+                "movq 0x28(%%rsp), %%rbx\n\t"
+                "movq 0x30(%%rsp), %%rbp\n\t"
+                "leaq 0x40(%%rsp), %%rsp\n\t"
+                // RAX == fctx, RDX == data as return value, RDI == fctx, RSI == data as argument of context-function
+                "movq %%rsi, %%rdx\n\t"
+                "movq %%rax, %%rdi\n\t"
+                "jmp *%%r8\n\t"
+                "1:\n\t"
+                // restore the red zone
+                "leaq 0x80(%%rsp), %%rsp\n\t"
+                : "=a"(ret.fctx), "=d"(ret.data), "+D"(to), "+S"(vp)
+                :
+                : "rbx", "rcx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5",
+                  "xmm6", "xmm7", "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15", "st", "st(1)", "st(2)",
+                  "st(3)", "st(4)", "st(5)", "st(6)", "st(7)", "mm0", "mm1", "mm2", "mm3", "mm4", "mm5", "mm6", "mm7", "fpsr", "cc",
+                  "memory" COPP_FCONTEXT_INLINE_JUMP_CLOBBER_AVX512);
+            return ret;
+        }
+    } // namespace fcontext
+} // namespace copp
+
+#undef COPP_FCONTEXT_INLINE_JUMP_SAVE_FPU
+#undef COPP_FCONTEXT_INLINE_JUMP_LOAD_FPU
+#undef COPP_FCONTEXT_INLINE_JUMP_CLOBBER_AVX512
+
+#endif
+
+#endif
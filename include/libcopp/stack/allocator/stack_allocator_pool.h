@@ -53,6 +53,22 @@ namespace copp {
                 }
             }
 
+            /**
+             * allocate memory of several stacks, the pool is locked only once
+             * @param ctxs stack contexts
+             * @param n number of stacks
+             * @param size ignored
+             * @return number of allocated stacks
+             */
+            std::size_t allocate_batch(stack_context *ctxs, std::size_t n, std::size_t size) UTIL_CONFIG_NOEXCEPT {
+                assert(pool_);
+                if (pool_) {
+                    return pool_->allocate_batch(ctxs, n);
+                }
+
+                return 0;
+            }
+
             /**
              * deallocate memory from stack context [standard function]
              * @param ctx stack context
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <utility>
+
 #include <libcopp/utils/features.h>
+#include <libcopp/stack/stack_context.h>
 
 #include "allocator/stack_allocator_malloc.h"
 #include "allocator/stack_allocator_memory.h"
@@ -37,4 +41,41 @@ namespace copp {
 
 #endif
 
+namespace copp {
+    namespace allocator {
+        namespace detail {
+            template <typename Ty>
+            struct stack_allocator_void {
+                typedef void type;
+            };
+        } // namespace detail
+
+        /**
+         * @brief allocate several stacks at once, TAlloc::allocate_batch is used if it's declared
+         * @note allocators without allocate_batch are called once for each stack
+         */
+        template <typename TAlloc, typename TEnable = void>
+        struct stack_allocator_batch {
+            static std::size_t allocate(TAlloc &alloc, stack_context *ctxs, std::size_t n, std::size_t size) UTIL_CONFIG_NOEXCEPT {
+                for (std::size_t i = 0; i < n; ++i) {
+                    alloc.allocate(ctxs[i], size);
+                    if (NULL == ctxs[i].sp) {
+                        return i;
+                    }
+                }
+
+                return n;
+            }
+        };
+
+        template <typename TAlloc>
+        struct stack_allocator_batch<TAlloc, typename detail::stack_allocator_void<STD_DECLTYPE(std::declval<TAlloc &>().allocate_batch(
+                                                 static_cast<stack_context *>(NULL), std::size_t(), std::size_t()))>::type> {
+            static std::size_t allocate(TAlloc &alloc, stack_context *ctxs, std::size_t n, std::size_t size) UTIL_CONFIG_NOEXCEPT {
+                return alloc.allocate_batch(ctxs, n, size);
+            }
+        };
+    } // namespace allocator
+} // namespace copp
+
 #endif /* STACK_ALLOCATOR_H_ */
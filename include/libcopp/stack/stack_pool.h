@@ -9,7 +9,7 @@
 
 #include <libcopp/utils/features.h>
 #include <libcopp/utils/lock_holder.h>
-#include <libcopp/utils/spin_lock.h>
+#include <libcopp/utils/thread_policy.h>
 #include <libcopp/utils/std/smart_ptr.h>
 
 
@@ -18,11 +18,12 @@
 
 
 namespace copp {
-    template <typename TAlloc>
+    template <typename TAlloc, typename TThreadPolicy = util::lock::default_thread_policy>
     class stack_pool {
     public:
         typedef TAlloc allocator_t;
-        typedef std::shared_ptr<stack_pool<TAlloc> > ptr_t;
+        typedef TThreadPolicy thread_policy_t;
+        typedef std::shared_ptr<stack_pool<TAlloc, TThreadPolicy> > ptr_t;
 
         struct limit_t {
             size_t used_stack_number;
@@ -106,9 +107,30 @@ namespace copp {
          * @note size must less or equal than attached
          */
         void allocate(stack_context &ctx) UTIL_CONFIG_NOEXCEPT {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-            util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
+            allocate_without_lock(ctx);
+        }
+
+        /**
+         * allocate memory of several stacks with only one lock
+         * @param ctxs stack contexts
+         * @param n number of stacks
+         * @return number of allocated stacks, the first ones of ctxs are filled
+         */
+        size_t allocate_batch(stack_context *ctxs, size_t n) UTIL_CONFIG_NOEXCEPT {
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
+            for (size_t i = 0; i < n; ++i) {
+                allocate_without_lock(ctxs[i]);
+                if (NULL == ctxs[i].sp) {
+                    return i;
+                }
+            }
+
+            return n;
+        }
+
+    private:
+        void allocate_without_lock(stack_context &ctx) UTIL_CONFIG_NOEXCEPT {
             // check limit
             if (0 != conf_.max_stack_number && limits_.used_stack_number >= conf_.max_stack_number) {
                 ctx.sp = NULL;
@@ -166,6 +188,7 @@ namespace copp {
             }
         }
 
+    public:
         /**
          * deallocate memory from stack context [standard function]
          * @param ctx stack context
@@ -173,9 +196,7 @@ namespace copp {
         void deallocate(stack_context &ctx) UTIL_CONFIG_NOEXCEPT {
             assert(ctx.sp && ctx.size > 0);
             do {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
                 // check ctx
                 if (ctx.sp == NULL || 0 == ctx.size) {
                     break;
@@ -230,9 +251,7 @@ namespace copp {
                 }
             }
 
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-            util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
             size_t keep_size = limits_.free_stack_size >> 1;
             size_t keep_number = limits_.free_stack_number >> 1;
@@ -278,9 +297,7 @@ namespace copp {
         }
 
         void clear() {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-            util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
             limits_.free_stack_size = 0;
             limits_.free_stack_number = 0;
@@ -296,9 +313,7 @@ namespace copp {
         limit_t limits_;
         configure_t conf_;
         allocator_t alloc_;
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-        util::lock::spin_lock action_lock_;
-#endif
+        typename thread_policy_t::lock_type action_lock_;
         std::list<stack_context> free_list_;
     };
 } // namespace copp
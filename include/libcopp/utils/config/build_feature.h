@@ -0,0 +1,37 @@
+// cmake template file
+
+#ifndef _COPP_UTILS_CONFIG_BUILD_FEATURES_H_
+#define _COPP_UTILS_CONFIG_BUILD_FEATURES_H_
+
+# pragma once
+
+/* #undef COPP_MACRO_USE_SEGMENTED_STACKS */
+#define COPP_MACRO_SYS_POSIX 1
+/* #undef COPP_MACRO_SYS_WIN */
+/* #undef COPP_MACRO_USE_VALGRIND */
+/* #undef PROJECT_DISABLE_MT */
+/* #undef LOCK_DISABLE_MT */
+#define COPP_MACRO_TLS_INITIAL_EXEC 1
+#define COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER 8
+
+#ifndef COPP_FCONTEXT_USE_TSX
+/* #undef COPP_FCONTEXT_USE_TSX */
+#endif
+
+#ifndef COPP_FCONTEXT_NO_FPU_CONTROL
+/* #undef COPP_FCONTEXT_NO_FPU_CONTROL */
+#endif
+
+#ifndef COPP_FCONTEXT_BACKEND_UCONTEXT
+/* #undef COPP_FCONTEXT_BACKEND_UCONTEXT */
+#endif
+
+#ifndef COPP_FCONTEXT_BACKEND_MINIMAL
+/* #undef COPP_FCONTEXT_BACKEND_MINIMAL */
+#endif
+
+#ifndef COPP_FCONTEXT_USE_INLINE_JUMP
+/* #undef COPP_FCONTEXT_USE_INLINE_JUMP */
+#endif
+
+#endif
@@ -29,6 +29,8 @@ namespace copp {
         COPP_EC_ALREADY_EXIST    = -1009, //!< COPP_EC_ALREADY_EXIST
         COPP_EC_ARGS_ERROR       = -1010, //!< COPP_EC_ARGS_ERROR
         COPP_EC_CAST_FAILED      = -1011, //!< COPP_EC_CAST_FAILED
+        COPP_EC_OUT_OF_RANGE     = -1012, //!< COPP_EC_OUT_OF_RANGE
+        COPP_EC_DEADLOCK         = -1013, //!< COPP_EC_DEADLOCK
 
         COPP_EC_FCONTEXT_MAKE_FAILED = -2001, //!< COPP_EC_FCONTEXT_MAKE_FAILED
 
@@ -36,6 +38,8 @@ namespace copp {
         COPP_EC_TASK_IS_EXITING        = -3002, //!< COPP_EC_TASK_IS_EXITING
         COPP_EC_TASK_ADD_NEXT_FAILED   = -3003, //!< COPP_EC_TASK_ADD_NEXT_FAILED
         COPP_EC_TASK_NOT_IN_ACTION     = -3004, //!< COPP_EC_TASK_NOT_IN_ACTION
+        COPP_EC_TASK_IS_AWAITING       = -3005, //!< COPP_EC_TASK_IS_AWAITING
+        COPP_EC_TASK_IS_INLINE         = -3006, //!< COPP_EC_TASK_IS_INLINE
     };
 } // namespace copp
 
@@ -85,6 +85,13 @@
 
 
 // ================ function flags ================
+#if defined(COPP_MACRO_COMPILER_MSVC)
+#define COPP_MACRO_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define COPP_MACRO_NOINLINE __attribute__((noinline))
+#else
+#define COPP_MACRO_NOINLINE
+#endif
 
 
 #if defined(COPP_MACRO_USE_SEGMENTED_STACKS)
@@ -117,6 +124,35 @@
 #if defined(_POSIX_MT_) || defined(_MSC_VER)
 #define COPP_MACRO_ENABLE_MULTI_THREAD
 #endif
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define COPP_MACRO_ENABLE_EXCEPTION 1
+#endif
+
+// C++20 coroutines, stackless tasks of cotask are available
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && defined(__has_include)
+#if __has_include(<coroutine>)
+#define COPP_MACRO_ENABLE_STD_COROUTINE 1
+#endif
+#endif
+
+// RTTI is not disabled by -fno-rtti or /GR-
+#ifndef COPP_MACRO_ENABLE_RTTI
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+#define COPP_MACRO_ENABLE_RTTI 1
+#endif
+#endif
+
+// number of coroutine-local slots in every coroutine_context
+#ifndef COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER
+#define COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER 8
+#endif
+
+// initial-exec TLS model, access to thread local variables is just a %fs/%gs relative load without __tls_get_addr
+#if defined(COPP_MACRO_TLS_INITIAL_EXEC) && COPP_MACRO_TLS_INITIAL_EXEC && defined(__GNUC__) && !defined(__APPLE__) && \
+    !defined(_WIN32) && !defined(__CYGWIN__) && !defined(__MINGW32__)
+#define COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC __thread __attribute__((tls_model("initial-exec")))
+#endif
 // ---------------- function flags ----------------
 
 
@@ -0,0 +1,91 @@
+/**
+ * @file thread_policy.h
+ * @brief threading policies of reference counters, status and locks
+ * Licensed under the MIT licenses.
+ *
+ * @version 1.0
+ * @author owent
+ * @date 2026-10-18
+ *
+ * @note types which are only used in one thread can choose single_thread_policy, and pay nothing for synchronization,
+ *       while other types in the same binary are still thread safe.
+ *
+ * @history
+ */
+
+#ifndef UTIL_LOCK_THREAD_POLICY_H
+#define UTIL_LOCK_THREAD_POLICY_H
+
+#pragma once
+
+#include <libcopp/utils/atomic_int_type.h>
+#include <libcopp/utils/config/build_feature.h>
+#include <libcopp/utils/spin_lock.h>
+
+namespace util {
+    namespace lock {
+        /**
+         * @brief lock which does nothing, used by single_thread_policy
+         */
+        class dummy_lock {
+        public:
+            inline void lock() {}
+            inline void unlock() {}
+            inline bool is_locked() { return false; }
+            inline bool try_lock() { return true; }
+            inline bool try_unlock() { return true; }
+        };
+
+        /**
+         * @brief atomic counters and spin locks, objects can be shared between threads
+         */
+        struct multi_thread_policy {
+            template <typename Ty>
+            struct atomic_type {
+                typedef ::util::lock::atomic_int_type<Ty> type;
+            };
+
+            typedef ::util::lock::spin_lock lock_type;
+        };
+
+        /**
+         * @brief plain counters and no lock, objects must be used in one thread
+         */
+        struct single_thread_policy {
+            template <typename Ty>
+            struct atomic_type {
+                typedef ::util::lock::atomic_int_type< ::util::lock::unsafe_int_type<Ty> > type;
+            };
+
+            typedef dummy_lock lock_type;
+        };
+
+#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
+        typedef single_thread_policy default_thread_policy;
+#else
+        typedef multi_thread_policy default_thread_policy;
+#endif
+
+        namespace detail {
+            template <typename Ty>
+            struct thread_policy_void {
+                typedef void type;
+            };
+        } // namespace detail
+
+        /**
+         * @brief TMacro::thread_policy_t, or default_thread_policy if it's not declared
+         */
+        template <typename TMacro, typename TEnable = void>
+        struct thread_policy_of {
+            typedef default_thread_policy type;
+        };
+
+        template <typename TMacro>
+        struct thread_policy_of<TMacro, typename detail::thread_policy_void<typename TMacro::thread_policy_t>::type> {
+            typedef typename TMacro::thread_policy_t type;
+        };
+    } // namespace lock
+} // namespace util
+
+#endif /* UTIL_LOCK_THREAD_POLICY_H */
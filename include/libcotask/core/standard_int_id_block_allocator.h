@@ -0,0 +1,133 @@
+﻿/*
+ * standard_int_id_block_allocator.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COTASK_CORE_STANDARD_INT_ID_BLOCK_ALLOCATOR_H
+#define COTASK_CORE_STANDARD_INT_ID_BLOCK_ALLOCATOR_H
+
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <stdint.h>
+
+
+#include <libcopp/utils/atomic_int_type.h>
+#include <libcopp/utils/features.h>
+#include <libcotask/impl/id_allocator_impl.h>
+
+namespace cotask {
+    namespace core {
+
+        /**
+         * @biref allocate a id of specify type, each thread takes a block of ids from the global sequence
+         * @note ids have the same layout as standard_int_id_allocator, time part in high bits and sequence in low bits.
+         *       when the sequence wraps in the same second, the time part is moved to the next second instead of waiting
+         *       for time(NULL), so ids will not repeated until the time part wraps.
+         *       ids are unique but not ordered between threads, and the rest of a block is lost when the thread exits.
+         */
+        template <typename TKey = uint64_t, size_t BLOCK_SIZE = 256>
+        class standard_int_id_block_allocator {
+        public:
+            typedef cotask::impl::id_allocator<TKey> base_type;
+            typedef typename base_type::value_type value_type;
+
+            static const value_type npos = 0; /** invalid key **/
+        private:
+            static const size_t seq_bits = sizeof(value_type) * 4;
+            static const value_type seq_mask = (static_cast<value_type>(1) << seq_bits) - 1;
+            static const value_type time_mask = (static_cast<value_type>(1) << (sizeof(value_type) * 8 - seq_bits)) - 1;
+
+            // a block never takes more than a quarter of the sequence
+            static const value_type block_size = static_cast<value_type>(
+                BLOCK_SIZE < 1 ? 1 : (BLOCK_SIZE < (seq_mask >> 2) ? BLOCK_SIZE : ((seq_mask >> 2) < 1 ? 1 : (seq_mask >> 2))));
+
+            struct block_t {
+                value_type next;
+                value_type end;
+            };
+
+#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
+            typedef util::lock::atomic_int_type<util::lock::unsafe_int_type<value_type> > seq_alloc_t;
+#else
+            typedef util::lock::atomic_int_type<value_type> seq_alloc_t;
+#endif
+
+            static seq_alloc_t &get_seq_alloc() {
+                // last id taken by any thread, time part 0 means not started
+                static seq_alloc_t ret(0);
+                return ret;
+            }
+
+            /**
+             * @brief take [out.next, out.end) from the global sequence
+             * @note it's the slow path, keep it out of allocate()
+             */
+            static COPP_MACRO_NOINLINE void alloc_block(block_t &out, value_type count) UTIL_CONFIG_NOEXCEPT {
+                seq_alloc_t &seq_alloc = get_seq_alloc();
+                value_type res = seq_alloc.load(util::lock::memory_order_acquire);
+                while (true) {
+                    value_type time_part = res >> seq_bits;
+                    value_type begin;
+
+                    if (0 == time_part || (res & seq_mask) > seq_mask - count) {
+                        value_type now_time = static_cast<value_type>(time(NULL)) & time_mask;
+                        // the sequence wraps in the same second, or a borrowed second is not reached yet,
+                        // borrow the next second
+                        value_type time_diff = (now_time - time_part) & time_mask;
+                        if (0 != time_part && (0 == time_diff || time_diff > (time_mask >> 1))) {
+                            now_time = (time_part + 1) & time_mask;
+                        }
+
+                        // always do not allocate 0 as a valid ID
+                        if (0 == now_time) {
+                            now_time = 1;
+                        }
+                        begin = now_time << seq_bits;
+                    } else {
+                        begin = res + 1;
+                    }
+
+                    // if failed, maybe another thread do it, try again with the new value
+                    if (seq_alloc.compare_exchange_weak(res, begin + count - 1, util::lock::memory_order_acq_rel,
+                                                        util::lock::memory_order_acquire)) {
+                        out.next = begin;
+                        out.end  = begin + count;
+                        return;
+                    }
+                }
+            }
+
+        public:
+            value_type allocate() UTIL_CONFIG_NOEXCEPT {
+#if (!defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)) && !defined(UTIL_CONFIG_THREAD_LOCAL)
+                // no thread local storage, every id is taken from the global sequence
+                block_t block;
+                alloc_block(block, 1);
+                return block.next;
+#else
+
+#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
+                static block_t block = {0, 0};
+#else
+                static UTIL_CONFIG_THREAD_LOCAL block_t block = {0, 0};
+#endif
+                if (block.next == block.end) {
+                    alloc_block(block, block_size);
+                }
+
+                return block.next++;
+#endif
+            }
+
+            void deallocate(value_type) UTIL_CONFIG_NOEXCEPT {}
+        };
+    }
+}
+
+#endif /* COTASK_CORE_STANDARD_INT_ID_BLOCK_ALLOCATOR_H */
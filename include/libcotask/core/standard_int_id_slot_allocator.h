@@ -0,0 +1,328 @@
+﻿/*
+ * standard_int_id_slot_allocator.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COTASK_CORE_STANDARD_INT_ID_SLOT_ALLOCATOR_H
+#define COTASK_CORE_STANDARD_INT_ID_SLOT_ALLOCATOR_H
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <stdint.h>
+
+
+#include <libcopp/utils/atomic_int_type.h>
+#include <libcopp/utils/features.h>
+#include <libcotask/impl/id_allocator_impl.h>
+
+#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
+#include <libcopp/utils/lock_holder.h>
+#include <libcopp/utils/spin_lock.h>
+#endif
+
+namespace cotask {
+    namespace core {
+
+        /**
+         * @biref allocate generational handles as ids, slot index in low bits and generation in high bits
+         * @note slots of deallocated ids are reused with a new generation, so a stale id never equals the id of a
+         *       living object until the generation wraps. slot indexes are dense, containers can use them as array
+         *       index, like task_slot_map.
+         *       each thread takes a block of new slots from the global index and keeps the slots it deallocated in its
+         *       own free list, so there is no shared lock or hot counter in allocate() and deallocate() in most cases.
+         *       a thread keeps at most 2 * BLOCK_SIZE free slots, the others are moved to a global free list in batches
+         *       of BLOCK_SIZE, and a thread without free slots takes a batch from it before taking new slots, so ids
+         *       allocated by one thread and deallocated by others are reused and the max slot index is bounded by the
+         *       number of living ids, plus the slots cached by threads.
+         *       slot indexes are shared by all users of the same TKey, so the max slot index, which is the size a
+         *       task_slot_map grows to, depends on the living tasks of all task types and all threads, not only the
+         *       ones in the container. the slots cached by a thread are lost when it exits.
+         */
+        template <typename TKey = uint64_t, size_t BLOCK_SIZE = 64>
+        class standard_int_id_slot_allocator {
+        public:
+            typedef cotask::impl::id_allocator<TKey> base_type;
+            typedef typename base_type::value_type value_type;
+
+            static const value_type npos = 0; /** invalid key **/
+
+            static const size_t index_bits = sizeof(value_type) * 4;
+            static const value_type index_mask = (static_cast<value_type>(1) << index_bits) - 1;
+            static const value_type generation_mask = (static_cast<value_type>(1) << (sizeof(value_type) * 8 - index_bits)) - 1;
+
+        private:
+            // slot index = (page << (page_bits + chunk_bits)) | (chunk << chunk_bits) | offset
+            static const size_t chunk_bits = index_bits < 10 ? index_bits : 10;
+            static const size_t page_bits = (index_bits - chunk_bits) < 10 ? (index_bits - chunk_bits) : 10;
+            static const size_t directory_bits = index_bits - chunk_bits - page_bits;
+
+            static const value_type block_size = static_cast<value_type>(
+                BLOCK_SIZE < 1 ? 1 : (BLOCK_SIZE < (static_cast<size_t>(1) << chunk_bits) ? BLOCK_SIZE : (static_cast<size_t>(1) << chunk_bits)));
+
+#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
+            typedef util::lock::atomic_int_type<util::lock::unsafe_int_type<value_type> > atomic_value_t;
+            typedef util::lock::atomic_int_type<util::lock::unsafe_int_type<uintptr_t> > pointer_t;
+#else
+            typedef util::lock::atomic_int_type<value_type> atomic_value_t;
+            typedef util::lock::atomic_int_type<uintptr_t> pointer_t;
+#endif
+
+            struct slot_chunk_t {
+                // 0 means the slot is never allocated
+                atomic_value_t generations[static_cast<size_t>(1) << chunk_bits];
+                // next free slot index + 1, only used by the thread which owns the free list
+                value_type next_free[static_cast<size_t>(1) << chunk_bits];
+                // next batch in the global free list, only used by the first slot of a batch
+                value_type next_batch[static_cast<size_t>(1) << chunk_bits];
+
+                slot_chunk_t() {
+                    for (size_t i = 0; i < (static_cast<size_t>(1) << chunk_bits); ++i) {
+                        generations[i].store(0, util::lock::memory_order_relaxed);
+                        next_free[i] = 0;
+                        next_batch[i] = 0;
+                    }
+                }
+            };
+
+            struct slot_page_t {
+                pointer_t chunks[static_cast<size_t>(1) << page_bits];
+            };
+
+            struct slot_table_t {
+                pointer_t pages[static_cast<size_t>(1) << directory_bits];
+                atomic_value_t next_index;
+                value_type free_batches; /** first slot index + 1 of the first batch in the global free list **/
+#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
+                util::lock::spin_lock free_lock; /** lock of free_batches **/
+#endif
+#if (!defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)) && !defined(UTIL_CONFIG_THREAD_LOCAL)
+                util::lock::spin_lock lock;
+#endif
+            };
+
+            struct thread_state_t {
+                value_type free_head; /** first free slot index + 1, 0 means empty **/
+                value_type free_count;
+                value_type next;
+                value_type end;
+            };
+
+            static slot_table_t &get_slot_table() {
+                // never destroyed, tasks with static storage may release their ids after exit() is called
+                static slot_table_t *ret = new slot_table_t();
+                return *ret;
+            }
+
+            static thread_state_t &get_thread_state() {
+#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
+                static thread_state_t ret = {0, 0, 0, 0};
+#elif !defined(UTIL_CONFIG_THREAD_LOCAL)
+                // no thread local storage, all threads share one state under the lock of slot table
+                static thread_state_t ret = {0, 0, 0, 0};
+#else
+                static UTIL_CONFIG_THREAD_LOCAL thread_state_t ret = {0, 0, 0, 0};
+#endif
+                return ret;
+            }
+
+            static inline size_t get_chunk_offset(value_type index) UTIL_CONFIG_NOEXCEPT {
+                return static_cast<size_t>(index) & ((static_cast<size_t>(1) << chunk_bits) - 1);
+            }
+
+            static slot_chunk_t *find_chunk(value_type index) UTIL_CONFIG_NOEXCEPT {
+                size_t page_index = static_cast<size_t>(index >> (chunk_bits + page_bits));
+                size_t chunk_index = static_cast<size_t>(index >> chunk_bits) & ((static_cast<size_t>(1) << page_bits) - 1);
+                slot_page_t *page = reinterpret_cast<slot_page_t *>(get_slot_table().pages[page_index].load(util::lock::memory_order_acquire));
+                if (UTIL_CONFIG_NULLPTR == page) {
+                    return UTIL_CONFIG_NULLPTR;
+                }
+
+                return reinterpret_cast<slot_chunk_t *>(page->chunks[chunk_index].load(util::lock::memory_order_acquire));
+            }
+
+            /**
+             * @brief the chunk may be created by another thread which takes a block in the same chunk
+             */
+            template <typename T>
+            static T *get_or_create(pointer_t &slot) UTIL_CONFIG_NOEXCEPT {
+                uintptr_t ret = slot.load(util::lock::memory_order_acquire);
+                if (0 != ret) {
+                    return reinterpret_cast<T *>(ret);
+                }
+
+                T *created = new (std::nothrow) T();
+                if (UTIL_CONFIG_NULLPTR == created) {
+                    return UTIL_CONFIG_NULLPTR;
+                }
+
+                if (slot.compare_exchange_strong(ret, reinterpret_cast<uintptr_t>(created), util::lock::memory_order_acq_rel,
+                                                 util::lock::memory_order_acquire)) {
+                    return created;
+                }
+
+                delete created;
+                return reinterpret_cast<T *>(ret);
+            }
+
+            /**
+             * @brief take a block of new slots, it's the slow path, keep it out of allocate()
+             */
+            static COPP_MACRO_NOINLINE bool alloc_block(thread_state_t &state) UTIL_CONFIG_NOEXCEPT {
+                slot_table_t &table = get_slot_table();
+                value_type begin = table.next_index.load(util::lock::memory_order_acquire);
+                value_type end;
+                do {
+                    if (begin > index_mask) {
+                        return false;
+                    }
+
+                    // blocks never cross chunks
+                    end = (begin | static_cast<value_type>((static_cast<size_t>(1) << chunk_bits) - 1)) + 1;
+                    if (end - begin > block_size) {
+                        end = begin + block_size;
+                    }
+                } while (!table.next_index.compare_exchange_weak(begin, end, util::lock::memory_order_acq_rel,
+                                                                 util::lock::memory_order_acquire));
+
+                slot_page_t *page = get_or_create<slot_page_t>(table.pages[static_cast<size_t>(begin >> (chunk_bits + page_bits))]);
+                if (UTIL_CONFIG_NULLPTR == page) {
+                    return false;
+                }
+
+                size_t chunk_index = static_cast<size_t>(begin >> chunk_bits) & ((static_cast<size_t>(1) << page_bits) - 1);
+                if (UTIL_CONFIG_NULLPTR == get_or_create<slot_chunk_t>(page->chunks[chunk_index])) {
+                    return false;
+                }
+
+                state.next = begin;
+                state.end = end;
+                return true;
+            }
+
+            /**
+             * @brief take a batch from the global free list
+             */
+            static COPP_MACRO_NOINLINE bool take_free_batch(thread_state_t &state) UTIL_CONFIG_NOEXCEPT {
+                slot_table_t &table = get_slot_table();
+#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
+                util::lock::lock_holder<util::lock::spin_lock> lock_guard(table.free_lock);
+#endif
+                if (0 == table.free_batches) {
+                    return false;
+                }
+
+                value_type head = table.free_batches;
+                slot_chunk_t *chunk = find_chunk(head - 1);
+                table.free_batches = chunk->next_batch[get_chunk_offset(head - 1)];
+
+                state.free_head = head;
+                state.free_count = block_size;
+                return true;
+            }
+
+            /**
+             * @brief move the first block_size slots of the free list of this thread to the global free list
+             */
+            static COPP_MACRO_NOINLINE void release_free_batch(thread_state_t &state) UTIL_CONFIG_NOEXCEPT {
+                value_type head = state.free_head;
+                value_type tail = head - 1;
+                slot_chunk_t *tail_chunk = find_chunk(tail);
+                for (value_type i = 1; i < block_size; ++i) {
+                    tail = tail_chunk->next_free[get_chunk_offset(tail)] - 1;
+                    tail_chunk = find_chunk(tail);
+                }
+
+                state.free_head = tail_chunk->next_free[get_chunk_offset(tail)];
+                state.free_count -= block_size;
+                tail_chunk->next_free[get_chunk_offset(tail)] = 0;
+
+                slot_table_t &table = get_slot_table();
+                slot_chunk_t *head_chunk = find_chunk(head - 1);
+#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
+                util::lock::lock_holder<util::lock::spin_lock> lock_guard(table.free_lock);
+#endif
+                head_chunk->next_batch[get_chunk_offset(head - 1)] = table.free_batches;
+                table.free_batches = head;
+            }
+
+        public:
+            /**
+             * @brief get slot index of a id
+             */
+            static inline value_type get_index(value_type id) UTIL_CONFIG_NOEXCEPT { return id & index_mask; }
+
+            /**
+             * @brief get generation of a id, generation of valid ids is never 0
+             */
+            static inline value_type get_generation(value_type id) UTIL_CONFIG_NOEXCEPT { return (id >> index_bits) & generation_mask; }
+
+            value_type allocate() UTIL_CONFIG_NOEXCEPT {
+#if (!defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)) && !defined(UTIL_CONFIG_THREAD_LOCAL)
+                util::lock::lock_holder<util::lock::spin_lock> lock_guard(get_slot_table().lock);
+#endif
+                thread_state_t &state = get_thread_state();
+
+                value_type index;
+                slot_chunk_t *chunk;
+                if (0 != state.free_head || take_free_batch(state)) {
+                    index = state.free_head - 1;
+                    chunk = find_chunk(index);
+                    state.free_head = chunk->next_free[get_chunk_offset(index)];
+                    --state.free_count;
+                } else {
+                    if (state.next == state.end && !alloc_block(state)) {
+                        return npos;
+                    }
+
+                    index = state.next++;
+                    chunk = find_chunk(index);
+                    chunk->generations[get_chunk_offset(index)].store(1, util::lock::memory_order_release);
+                }
+
+                return (chunk->generations[get_chunk_offset(index)].load(util::lock::memory_order_acquire) << index_bits) | index;
+            }
+
+            void deallocate(value_type id) UTIL_CONFIG_NOEXCEPT {
+                if (npos == id) {
+                    return;
+                }
+
+                value_type index = get_index(id);
+                value_type generation = get_generation(id);
+                slot_chunk_t *chunk = find_chunk(index);
+                if (0 == generation || UTIL_CONFIG_NULLPTR == chunk) {
+                    return;
+                }
+
+                // invalidate all handles of this slot, and always do not use 0 as a valid generation
+                // stale ids and ids of slots never allocated do not match
+                value_type next_generation = (generation + 1) & generation_mask;
+                if (0 == next_generation) {
+                    next_generation = 1;
+                }
+                if (!chunk->generations[get_chunk_offset(index)].compare_exchange_strong(
+                        generation, next_generation, util::lock::memory_order_acq_rel, util::lock::memory_order_acquire)) {
+                    return;
+                }
+
+#if (!defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)) && !defined(UTIL_CONFIG_THREAD_LOCAL)
+                util::lock::lock_holder<util::lock::spin_lock> lock_guard(get_slot_table().lock);
+#endif
+                thread_state_t &state = get_thread_state();
+                chunk->next_free[get_chunk_offset(index)] = state.free_head;
+                state.free_head = index + 1;
+                if (++state.free_count >= 2 * block_size) {
+                    release_free_batch(state);
+                }
+            }
+        };
+    }
+}
+
+#endif /* COTASK_CORE_STANDARD_INT_ID_SLOT_ALLOCATOR_H */
@@ -17,11 +17,34 @@ namespace cotask {
 
         class task_impl;
 
+        /**
+         * @brief address of value is unique for each type, it's used to check the type of results without RTTI
+         */
+        template <typename Ty>
+        struct task_result_type_id {
+            static const char value;
+        };
+
+        template <typename Ty>
+        const char task_result_type_id<Ty>::value = 0;
+
         class task_action_impl {
         public:
             virtual ~task_action_impl() {}
             virtual int operator()(void *) = 0;
             virtual int on_finished(task_impl &) { return 0; }
+
+            /**
+             * @brief get address of the result
+             * @param type_id address of task_result_type_id<T>::value
+             * @return address of the result, or NULL if there is no result of this type
+             */
+            virtual void *get_result(const void * /*type_id*/) { return 0; }
+
+            /**
+             * @brief destroy the result
+             */
+            virtual void reset_result() {}
         };
     } // namespace impl
 } // namespace cotask
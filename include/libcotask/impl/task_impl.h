@@ -15,6 +15,7 @@
 #include <list>
 #include <stdint.h>
 
+#include <libcopp/coroutine/coroutine_context.h>
 #include <libcopp/utils/atomic_int_type.h>
 #include <libcopp/utils/config/compiler_features.h>
 #include <libcopp/utils/std/smart_ptr.h>
@@ -30,13 +31,33 @@ namespace cotask {
         EN_TS_CREATED,
         EN_TS_RUNNING,
         EN_TS_WAITING,
+        EN_TS_AWAITING, // parked by await(), only the awaited task can resume it
         EN_TS_DONE,
         EN_TS_CANCELED,
         EN_TS_KILLED,
         EN_TS_TIMEOUT,
     };
 
+    /**
+     * @brief how to run next tasks and wake awaiting tasks when a task finished, it's set for every thread
+     */
+    enum EN_TASK_DISPATCH_MODE {
+        EN_TDM_INLINE = 0, // run them in start() of the finished task, long next() chains recurse on the stack of caller
+        EN_TDM_TRAMPOLINE, // queue them, and the outermost dispatch of this thread runs them one by one
+        EN_TDM_DEFERRED,   // queue them until task_impl::dispatch_pending() is called
+    };
+
     namespace impl {
+        class task_impl;
+
+        namespace detail {
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+            /**
+             * @brief inline task running on this thread, it's written by task_impl::_exchange_inline_task()
+             */
+            extern COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC task_impl *gt_current_inline_task;
+#endif
+        } // namespace detail
 
         class task_impl {
         protected:
@@ -97,11 +118,55 @@ namespace cotask {
 
             virtual int on_finished();
 
+            /**
+             * @brief set dispatch mode of next tasks and awaiting tasks in this thread
+             * @param mode dispatch mode, default is EN_TDM_INLINE
+             */
+            static void set_dispatch_mode(EN_TASK_DISPATCH_MODE mode);
+
+            /**
+             * @brief get dispatch mode of next tasks and awaiting tasks in this thread
+             */
+            static EN_TASK_DISPATCH_MODE get_dispatch_mode();
+
+            /**
+             * @brief run queued next tasks and awaiting tasks of this thread in order
+             * @note tasks queued when running them are also run in this call, unless max_number is reached.
+             *       It returns 0 when called in another dispatch_pending() of this thread.
+             * @param max_number max number of tasks to run, 0 means until the queue is empty
+             * @return number of tasks run
+             */
+            static size_t dispatch_pending(size_t max_number = 0);
+
+            /**
+             * @brief get number of queued next tasks and awaiting tasks of this thread
+             */
+            static size_t get_pending_dispatch_number();
+
             /**
              * get current running task
              * @return current running task or empty pointer
              */
-            static task_impl *this_task();
+            static inline task_impl *this_task() UTIL_CONFIG_NOEXCEPT {
+                copp::coroutine_context *this_co = copp::this_coroutine::get_coroutine();
+                if (UTIL_CONFIG_NULLPTR == this_co) {
+                    // inline tasks run without coroutine
+                    return _get_inline_task();
+                }
+
+                if (false == this_co->check_flags(ext_coroutine_flag_t::EN_ECFT_COTASK)) {
+                    return UTIL_CONFIG_NULLPTR;
+                }
+
+                return *reinterpret_cast<task_impl **>(this_co->get_private_buffer());
+            }
+
+            /**
+             * @brief get type tag of the task object
+             * @note it's the address of task_result_type_id<T>::value of the task type T, used to convert tasks without RTTI
+             * @return type tag, or NULL if it's not set by the task type
+             */
+            inline const void *get_type_id() const UTIL_CONFIG_NOEXCEPT { return type_id_; }
 
             /**
              * @brief get raw action pointer
@@ -111,20 +176,46 @@ namespace cotask {
             inline action_ptr_t get_raw_action() const UTIL_CONFIG_NOEXCEPT { return action_; }
 
         protected:
+            struct dispatch_entry_t {
+                task_impl *task; // a reference is held by the entry
+                void *priv_data;
+                EN_TASK_STATUS expected_status; // EN_TS_AWAITING to wake an awaiting task, or EN_TS_INVALID to start or resume a next task
+                void (*dispatch_fn)(dispatch_entry_t &entry, bool run); // run the task if run is true, and then release the reference
+            };
+
+            static void _push_dispatch(const dispatch_entry_t &entry);
+
+            /**
+             * @brief set the inline task running on this thread, and return the old one
+             */
+            static task_impl *_exchange_inline_task(task_impl *task);
+
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+            static inline task_impl *_get_inline_task() UTIL_CONFIG_NOEXCEPT { return detail::gt_current_inline_task; }
+#else
+            static task_impl *_get_inline_task() UTIL_CONFIG_NOEXCEPT;
+#endif
+
             void _set_action(action_ptr_t action);
             action_ptr_t _get_action();
 
+            inline void _set_type_id(const void *type_id) UTIL_CONFIG_NOEXCEPT { type_id_ = type_id; }
+
             bool _cas_status(EN_TASK_STATUS &expected, EN_TASK_STATUS desired);
 
             int _notify_finished(void *priv_data);
 
         private:
             action_ptr_t action_;
+            const void *type_id_;
 
         protected:
             void *finish_priv_data_;
 
         private:
+            struct dispatch_context_t;
+            static dispatch_context_t *get_dispatch_context();
+
 #if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
             ::util::lock::atomic_int_type<uint32_t> status_;
 #else
@@ -13,16 +13,22 @@
 #pragma once
 
 #include <algorithm>
+#include <new>
 #include <stdint.h>
+#include <vector>
 
 #include <libcopp/stack/stack_traits.h>
 #include <libcopp/utils/errno.h>
 #include <libcotask/task_macros.h>
+#include <libcotask/task_stackless.h>
 #include <libcotask/this_task.h>
 
 
 namespace cotask {
 
+    template <typename TAct, typename TCO_MACRO, typename TTASK_MACRO>
+    class task_pool;
+
     template <typename TCO_MACRO = macro_coroutine, typename TTASK_MACRO = macro_task>
     class task : public impl::task_impl {
     public:
@@ -37,23 +43,73 @@ namespace cotask {
         typedef typename macro_task_t::id_t           id_t;
         typedef typename macro_task_t::id_allocator_t id_allocator_t;
 
+        // atomic or plain counters of this task type, see util::lock::single_thread_policy
+        typedef typename util::lock::thread_policy_of<macro_task_t>::type thread_policy_t;
+
 
-        struct task_group {
-            std::list<std::pair<ptr_t, void *> > member_list_;
+        /**
+         * @brief receive the coroutine of a released task, so the stack can be reused by another task
+         * @see task_pool
+         */
+        class recycler_t {
+        public:
+            virtual ~recycler_t() {}
+            virtual void recycle(typename coroutine_t::ptr_t &coroutine) = 0;
         };
 
     private:
         typedef impl::task_impl::action_ptr_t action_ptr_t;
 
+        template <typename TAct, typename TCO, typename TTASK>
+        friend class task_pool;
+
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+        template <typename TTask>
+        friend class task_awaiter;
+#endif
+
+        // how to create the stack of a task created by create_lazy, it's placed after the task and the action
+        struct lazy_stack_t {
+            typename coroutine_t::allocator_type alloc;
+            size_t stack_size;
+            size_t private_buffer_size;
+            int ret_code; // return code is kept here after the stack is released
+            bool stackless; // created by create_stackless, the action runs a C++20 coroutine and no stack is allocated
+            bool run_inline;      // created by create_inline, the action runs on the stack of caller
+            bool inline_finished; // the action of an inline task returned
+        };
+
+        // continuation added by next() or await(), the first one is stored in the task, so it's not allocated in most cases
+        struct next_node_t {
+            next_node_t *next;
+            ptr_t task;
+            void *priv_data;
+            uint32_t await_generation; // generation of the wait when it's added by await()
+            bool is_awaiter;           // added by await(), the task is woken only if this is the last one it's waiting for
+            void (*dispatch_fn)(dispatch_entry_t &entry, bool run); // set if it's not a task but a C++20 coroutine in priv_data
+        };
+
+        // runner of the coroutine bound by a lazy task, small enough to be stored in std::function without allocation
+        struct lazy_runner_t {
+            impl::task_action_impl *action;
+            inline int operator()(void *priv_data) { return (*action)(priv_data); }
+        };
+
     public:
         /**
          * @brief constuctor
          * @note should not be called directly
          */
-        task() : action_destroy_fn_(UTIL_CONFIG_NULLPTR) {
+        task() : action_destroy_fn_(UTIL_CONFIG_NULLPTR), unwind_on_kill_(false), lazy_stack_(UTIL_CONFIG_NULLPTR),
+                 await_parking_(false) {
             id_allocator_t id_alloc_;
             id_ = id_alloc_.allocate();
+            _set_type_id(&impl::task_result_type_id<self_t>::value);
             ref_count_.store(0);
+            await_state_.store(0);
+            next_head_.store(0);
+            inline_next_used_.store(0);
+            detach_state_.store(EN_TDS_NONE);
         }
 
 
@@ -73,6 +129,21 @@ namespace cotask {
         static ptr_t create_with_delegate(const Ty &callable, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
                                           size_t private_buffer_size = 0) {
 #endif
+            typename coroutine_t::ptr_t coroutine = create_coroutine<TAct>(alloc, stack_size, private_buffer_size);
+            if (!coroutine) {
+                return ptr_t();
+            }
+
+            return create_on_coroutine<TAct>(coroutine, COPP_MACRO_STD_FORWARD(Ty, callable), true);
+        }
+
+    private:
+        /**
+         * @brief create the coroutine of a task, with space for the task and TAct on the top of its stack
+         */
+        template <typename TAct>
+        static typename coroutine_t::ptr_t create_coroutine(typename coroutine_t::allocator_type &alloc, size_t stack_size,
+                                                            size_t private_buffer_size) {
             typedef TAct a_t;
 
             if (0 == stack_size) {
@@ -83,14 +154,28 @@ namespace cotask {
             size_t task_size   = coroutine_t::align_address_size(sizeof(self_t));
 
             if (stack_size <= sizeof(impl::task_impl *) + private_buffer_size + action_size + task_size) {
-                return ptr_t();
+                return typename coroutine_t::ptr_t();
             }
 
-            typename coroutine_t::ptr_t coroutine = coroutine_t::create(
-                (a_t *)(UTIL_CONFIG_NULLPTR), alloc, stack_size, sizeof(impl::task_impl *) + private_buffer_size, action_size + task_size);
-            if (!coroutine) {
-                return ptr_t();
-            }
+            return coroutine_t::create((a_t *)(UTIL_CONFIG_NULLPTR), alloc, stack_size, sizeof(impl::task_impl *) + private_buffer_size,
+                                       action_size + task_size);
+        }
+
+        /**
+         * @brief placement new task and action on the coroutine created by create_coroutine<TAct>
+         * @param set_runner false if the coroutine is restarted and its runner is still bound to the action address
+         */
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename TAct, typename Ty>
+        static ptr_t create_on_coroutine(typename coroutine_t::ptr_t &coroutine, Ty &&callable, bool set_runner) {
+#else
+        template <typename TAct, typename Ty>
+        static ptr_t create_on_coroutine(typename coroutine_t::ptr_t &coroutine, const Ty &callable, bool set_runner) {
+#endif
+            typedef TAct a_t;
+
+            size_t action_size = coroutine_t::align_address_size(sizeof(a_t));
+            size_t task_size   = coroutine_t::align_address_size(sizeof(self_t));
 
             void *action_addr = sub_buffer_offset(coroutine.get(), action_size);
             void *task_addr   = sub_buffer_offset(action_addr, task_size);
@@ -111,17 +196,19 @@ namespace cotask {
                 return ret;
             }
 
-            typedef int (a_t::*a_t_fn_t)(void *);
-            a_t_fn_t a_t_fn = &a_t::operator();
+            if (set_runner) {
+                typedef int (a_t::*a_t_fn_t)(void *);
+                a_t_fn_t a_t_fn = &a_t::operator();
 
-            // redirect runner
-            coroutine->set_runner(
+                // redirect runner
+                coroutine->set_runner(
 #if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
-                std::move(std::bind(a_t_fn, action, std::placeholders::_1))
+                    std::move(std::bind(a_t_fn, action, std::placeholders::_1))
 #else
-                std::bind(a_t_fn, action, std::placeholders::_1)
+                    std::bind(a_t_fn, action, std::placeholders::_1)
 #endif
-            );
+                );
+            }
 
             ret->action_destroy_fn_ = get_placement_destroy(action);
             ret->_set_action(action);
@@ -129,7 +216,7 @@ namespace cotask {
             return ret;
         }
 
-
+    public:
 /**
  * @brief create task with functor
  * @param action
@@ -205,6 +292,276 @@ namespace cotask {
             return create(func, instance, alloc, stack_size, private_buffer_size);
         }
 
+/**
+ * @brief create task with functor which returns a TResult, the result can be got by get_result<TResult>() after the task finished
+ * @note The result is stored in the action, which is placed with the task, so it costs no extra allocation and it's kept
+ *       until the task is released, even if the stack of a lazy task is already released.
+ *       Use create_lazy_with_delegate<task_action_result<TResult, Ty> >(...) or task_pool<task_action_result<TResult, Ty> >
+ *       for lazy tasks and recycled tasks.
+ * @param functor functor or function of TResult(void*)
+ * @param stack_size stack size
+ * @param private_buffer_size buffer size to store private data
+ * @return task smart pointer
+ */
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename TResult, typename Ty>
+        static inline ptr_t create_with_result(Ty &&functor, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                               size_t private_buffer_size = 0) {
+            typedef task_action_result<TResult, typename std::decay<Ty>::type> a_t;
+            return create_with_delegate<a_t>(COPP_MACRO_STD_FORWARD(Ty, functor), alloc, stack_size, private_buffer_size);
+        }
+
+        template <typename TResult, typename Ty>
+        static inline ptr_t create_with_result(Ty &&functor, size_t stack_size = 0, size_t private_buffer_size = 0) {
+            typename coroutine_t::allocator_type alloc;
+            return create_with_result<TResult>(COPP_MACRO_STD_FORWARD(Ty, functor), alloc, stack_size, private_buffer_size);
+        }
+#else
+        template <typename TResult, typename Ty>
+        static inline ptr_t create_with_result(const Ty &functor, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                               size_t private_buffer_size = 0) {
+            typedef task_action_result<TResult, Ty> a_t;
+            return create_with_delegate<a_t>(functor, alloc, stack_size, private_buffer_size);
+        }
+
+        template <typename TResult, typename Ty>
+        static inline ptr_t create_with_result(const Ty &functor, size_t stack_size = 0, size_t private_buffer_size = 0) {
+            typename coroutine_t::allocator_type alloc;
+            return create_with_result<TResult>(functor, alloc, stack_size, private_buffer_size);
+        }
+#endif
+
+        /**
+         * @brief create n tasks with functors made by functor_factory(i), i is in [0, n)
+         * @note All the stacks are allocated before any task is constructed. Allocators with allocate_batch(), such as
+         *       copp::allocator::stack_allocator_pool, take all of them in one call, which locks the stack pool only once.
+         *       Each task keeps a copy of alloc.
+         * @param n number of tasks
+         * @param functor_factory called with the index of each task, returns the functor of the task
+         * @param alloc stack allocator
+         * @param stack_size stack size
+         * @param private_buffer_size buffer size to store private data
+         * @return task smart pointers, less than n if the allocator is out of stacks
+         */
+        template <typename TFactory>
+        static std::vector<ptr_t> create_batch(size_t n, TFactory functor_factory, typename coroutine_t::allocator_type &alloc,
+                                               size_t stack_size = 0, size_t private_buffer_size = 0) {
+            typedef typename std::decay<STD_DECLTYPE(functor_factory(static_cast<size_t>(0)))>::type f_t;
+            typedef typename std::conditional<std::is_base_of<impl::task_action_impl, f_t>::value, f_t, task_action_functor<f_t> >::type a_t;
+
+            std::vector<ptr_t> ret;
+            if (0 == stack_size) {
+                stack_size = copp::stack_traits::default_size();
+            }
+
+            size_t action_size = coroutine_t::align_address_size(sizeof(a_t));
+            size_t task_size   = coroutine_t::align_address_size(sizeof(self_t));
+            if (0 == n || stack_size <= sizeof(impl::task_impl *) + private_buffer_size + action_size + task_size) {
+                return ret;
+            }
+
+            std::vector<copp::stack_context> stacks(n);
+            size_t stack_number = copp::allocator::stack_allocator_batch<typename coroutine_t::allocator_type>::allocate(
+                alloc, &stacks[0], n, stack_size);
+
+            ret.reserve(stack_number);
+            for (size_t i = 0; i < stack_number; ++i) {
+                typename coroutine_t::allocator_type task_alloc(alloc);
+                typename coroutine_t::ptr_t          coroutine = coroutine_t::create_on_stack(
+                    typename coroutine_t::callback_t(), task_alloc, stacks[i], sizeof(impl::task_impl *) + private_buffer_size,
+                    action_size + task_size);
+                if (!coroutine) {
+                    // give back the left stacks
+                    for (size_t j = i + 1; j < stack_number; ++j) {
+                        alloc.deallocate(stacks[j]);
+                    }
+                    break;
+                }
+
+                ret.push_back(create_on_coroutine<a_t>(coroutine, functor_factory(i), true));
+            }
+
+            return ret;
+        }
+
+        template <typename TFactory>
+        static inline std::vector<ptr_t> create_batch(size_t n, TFactory functor_factory, size_t stack_size = 0,
+                                                      size_t private_buffer_size = 0) {
+            typename coroutine_t::allocator_type alloc;
+            return create_batch(n, functor_factory, alloc, stack_size, private_buffer_size);
+        }
+
+/**
+ * @brief create task with functor, but allocate the stack when it's started
+ * @note The task and the action are placed in one heap block, the stack is allocated from alloc by the first start(),
+ *       so tasks waiting in queues do not hold stacks. And the stack is released as soon as the task finishes, so
+ *       handles of finished tasks do not hold stacks either, get_ret_code() still works after that.
+ *       get_coroutine_context() is empty and get_private_buffer() returns NULL when there is no stack.
+ * @param action
+ * @param alloc stack allocator, a copy of it is kept until the stack is allocated
+ * @param stack_size stack size
+ * @param private_buffer_size buffer size to store private data
+ * @return task smart pointer
+ */
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename TAct, typename Ty>
+        static ptr_t create_lazy_with_delegate(Ty &&callable, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                               size_t private_buffer_size = 0) {
+#else
+        template <typename TAct, typename Ty>
+        static ptr_t create_lazy_with_delegate(const Ty &callable, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                               size_t private_buffer_size = 0) {
+#endif
+            typedef TAct a_t;
+
+            size_t task_size   = coroutine_t::align_address_size(sizeof(self_t));
+            size_t action_size = coroutine_t::align_address_size(sizeof(a_t));
+
+            // |task..padding..|action..padding..|lazy_stack_t|
+            void *block = ::operator new(task_size + action_size + sizeof(lazy_stack_t), std::nothrow);
+            if (UTIL_CONFIG_NULLPTR == block) {
+                return ptr_t();
+            }
+
+            void *action_addr = add_buffer_offset(block, task_size);
+            void *lazy_addr   = add_buffer_offset(action_addr, action_size);
+
+            // placement new task
+            ptr_t ret(new (block) self_t());
+
+            lazy_stack_t *lazy_stack        = new (lazy_addr) lazy_stack_t();
+            lazy_stack->alloc               = alloc;
+            lazy_stack->stack_size          = stack_size;
+            lazy_stack->private_buffer_size = private_buffer_size;
+            lazy_stack->ret_code            = 0;
+            lazy_stack->stackless           = false;
+            lazy_stack->run_inline          = false;
+            lazy_stack->inline_finished     = false;
+            ret->lazy_stack_                = lazy_stack;
+
+            // placement new action
+            a_t *action = new (action_addr) a_t(COPP_MACRO_STD_FORWARD(Ty, callable));
+
+            ret->action_destroy_fn_ = get_placement_destroy(action);
+            ret->_set_action(action);
+
+            return ret;
+        }
+
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename Ty>
+        static inline ptr_t create_lazy(Ty &&functor, size_t stack_size = 0, size_t private_buffer_size = 0) {
+            typename coroutine_t::allocator_type alloc;
+            return create_lazy(COPP_MACRO_STD_FORWARD(Ty, functor), alloc, stack_size, private_buffer_size);
+        }
+
+        template <typename Ty>
+        static inline ptr_t create_lazy(Ty &&functor, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                        size_t private_buffer_size = 0) {
+            typedef typename std::conditional<std::is_base_of<impl::task_action_impl, Ty>::value, Ty, task_action_functor<Ty> >::type a_t;
+            return create_lazy_with_delegate<a_t>(COPP_MACRO_STD_FORWARD(Ty, functor), alloc, stack_size, private_buffer_size);
+        }
+#else
+        template <typename Ty>
+        static inline ptr_t create_lazy(const Ty &functor, size_t stack_size = 0, size_t private_buffer_size = 0) {
+            typename coroutine_t::allocator_type alloc;
+            return create_lazy(functor, alloc, stack_size, private_buffer_size);
+        }
+
+        template <typename Ty>
+        static ptr_t create_lazy(const Ty &functor, typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                 size_t private_buffer_size = 0) {
+            typedef typename std::conditional<std::is_base_of<impl::task_action_impl, Ty>::value, Ty, task_action_functor<Ty> >::type a_t;
+            return create_lazy_with_delegate<a_t>(functor, alloc, stack_size, private_buffer_size);
+        }
+#endif
+
+        template <typename Ty>
+        static inline ptr_t create_lazy(Ty (*func)(void *), typename coroutine_t::allocator_type &alloc, size_t stack_size = 0,
+                                        size_t private_buffer_size = 0) {
+            typedef task_action_function<Ty> a_t;
+
+            return create_lazy_with_delegate<a_t>(func, alloc, stack_size, private_buffer_size);
+        }
+
+        template <typename Ty>
+        inline static ptr_t create_lazy(Ty (*func)(void *), size_t stack_size = 0, size_t private_buffer_size = 0) {
+            typename coroutine_t::allocator_type alloc;
+            return create_lazy(func, alloc, stack_size, private_buffer_size);
+        }
+
+/**
+ * @brief create task which runs its action on the stack of caller, no stack is allocated for it
+ * @note It's for actions which never yield, like cache hits. The task and the action are placed in one heap block like
+ *       create_lazy, and the action runs to completion in start(), so there is no context switch.
+ *       It has an id, and works with task_manager, next(), await() and when_all() like other tasks.
+ *       this_task() returns it in the action, but yield(), await() and when_all() of it return COPP_EC_TASK_IS_INLINE.
+ * @param functor functor or action object, or function of int(void*)
+ * @return task smart pointer
+ */
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename Ty>
+        static ptr_t create_inline(Ty &&functor) {
+            typedef typename std::conditional<std::is_base_of<impl::task_action_impl, Ty>::value, Ty, task_action_functor<Ty> >::type a_t;
+            return create_inline_with_delegate<a_t>(COPP_MACRO_STD_FORWARD(Ty, functor));
+        }
+#else
+        template <typename Ty>
+        static ptr_t create_inline(const Ty &functor) {
+            typedef typename std::conditional<std::is_base_of<impl::task_action_impl, Ty>::value, Ty, task_action_functor<Ty> >::type a_t;
+            return create_inline_with_delegate<a_t>(functor);
+        }
+#endif
+
+        template <typename Ty>
+        static ptr_t create_inline(Ty (*func)(void *)) {
+            typedef task_action_function<Ty> a_t;
+            return create_inline_with_delegate<a_t>(func);
+        }
+
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename TAct, typename Ty>
+        static ptr_t create_inline_with_delegate(Ty &&callable) {
+#else
+        template <typename TAct, typename Ty>
+        static ptr_t create_inline_with_delegate(const Ty &callable) {
+#endif
+            typename coroutine_t::allocator_type alloc;
+            ptr_t ret = create_lazy_with_delegate<TAct>(COPP_MACRO_STD_FORWARD(Ty, callable), alloc, 0, 0);
+            if (ret) {
+                ret->lazy_stack_->run_inline = true;
+            }
+
+            return ret;
+        }
+
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+        /**
+         * @brief create task which runs a C++20 coroutine, no stack is allocated for it
+         * @note The task and the action are placed in one heap block like create_lazy, and the coroutine frame is created
+         *       by functor(priv_data) in the first start(). Every start() or resume() resumes the coroutine until it's
+         *       suspended, and the frame is released as soon as the coroutine finished.
+         *       It has an id, and works with task_manager, next(), await() and when_all() like stackful tasks. kill()
+         *       and timeout destroy the frame of the suspended coroutine.
+         *       In the coroutine, use co_await std::suspend_always() to yield, and co_await a task pointer to await it.
+         *       this_task() and yield() do not work in it.
+         * @param functor functor or function of stackless_routine(void*), which is a C++20 coroutine
+         * @return task smart pointer
+         */
+        template <typename Ty>
+        static ptr_t create_stackless(Ty &&functor) {
+            typedef task_action_stackless<typename std::decay<Ty>::type> a_t;
+
+            typename coroutine_t::allocator_type alloc;
+            ptr_t ret = create_lazy_with_delegate<a_t>(std::forward<Ty>(functor), alloc, 0, 0);
+            if (ret) {
+                ret->lazy_stack_->stackless = true;
+            }
+
+            return ret;
+        }
+#endif
+
 #if defined(UTIL_CONFIG_COMPILER_CXX_VARIADIC_TEMPLATES) && UTIL_CONFIG_COMPILER_CXX_VARIADIC_TEMPLATES
         /**
          * @brief create task with functor type and parameters
@@ -226,6 +583,10 @@ namespace cotask {
          * @brief await another cotask to finish
          * @note please not to make tasks refer to each other. [it will lead to memory leak]
          * @note [don't do that] ptr_t a = ..., b = ...; a.await(b); b.await(a);
+         * @note this task is parked with status EN_TS_AWAITING until wait_task finishes, start() and resume() of it return
+         *       COPP_EC_TASK_IS_AWAITING, and it's resumed once by wait_task when wait_task finishes.
+         *       kill() and cancel() still works, and then COPP_EC_TASK_IS_EXITING is returned.
+         * @see when_all
          * @param wait_task which stack to wait for
          * @return 0 or error code
          */
@@ -251,27 +612,68 @@ namespace cotask {
                 return copp::COPP_EC_TASK_NOT_IN_ACTION;
             }
 
-            // add to next list failed
-            if (wait_task->next(ptr_t(this)).get() != this) {
-                return copp::COPP_EC_TASK_ADD_NEXT_FAILED;
+            return await_tasks(&wait_task, &wait_task + 1, true);
+        }
+
+        template <typename TTask>
+        inline int await(TTask *wait_task) {
+            return await(ptr_t(wait_task));
+        }
+
+        /**
+         * @brief await all the tasks to finish
+         * @note this task is parked with status EN_TS_AWAITING and resumed only once, by the last finished task.
+         *       Every task decrements a countdown of this task when it finishes, so there is no switch for the others.
+         * @note please not to make tasks refer to each other. [it will lead to memory leak]
+         * @param tasks tasks to wait for, finished tasks are allowed
+         * @return 0 or error code
+         */
+        inline int when_all(const std::vector<ptr_t> &tasks) {
+            if (tasks.empty()) {
+                return copp::COPP_EC_SUCCESS;
             }
 
-            int ret = 0;
-            while (!(wait_task->is_exiting() || wait_task->is_completed())) {
-                if (is_exiting()) {
-                    return copp::COPP_EC_TASK_IS_EXITING;
-                }
+            return await_tasks(&tasks[0], &tasks[0] + tasks.size(), true);
+        }
 
-                ret = yield();
+        /**
+         * @brief await any of the tasks to finish
+         * @note this task is parked with status EN_TS_AWAITING and resumed only once, by the first finished task.
+         *       Other tasks still hold this task until they finish, and then they do not resume it.
+         * @note please not to make tasks refer to each other. [it will lead to memory leak]
+         * @param tasks tasks to wait for, if any of them is finished, return immediately
+         * @return index of a finished task in tasks, or error code
+         */
+        inline int when_any(const std::vector<ptr_t> &tasks) {
+            if (tasks.empty()) {
+                return copp::COPP_EC_ARGS_ERROR;
             }
 
-            return ret;
+            return await_any_index(&tasks[0], &tasks[0] + tasks.size());
         }
 
-        template <typename TTask>
-        inline int await(TTask *wait_task) {
-            return await(ptr_t(wait_task));
+#if defined(UTIL_CONFIG_COMPILER_CXX_VARIADIC_TEMPLATES) && UTIL_CONFIG_COMPILER_CXX_VARIADIC_TEMPLATES
+        /**
+         * @brief await all the tasks to finish
+         * @see when_all(const std::vector<ptr_t> &)
+         */
+        template <typename... TTasks>
+        inline int when_all(const ptr_t &first, const TTasks &... others) {
+            ptr_t tasks[] = {first, ptr_t(others)...};
+            return await_tasks(tasks, tasks + 1 + sizeof...(others), true);
+        }
+
+        /**
+         * @brief await any of the tasks to finish
+         * @see when_any(const std::vector<ptr_t> &)
+         * @return index of a finished task in arguments, or error code
+         */
+        template <typename... TTasks>
+        inline int when_any(const ptr_t &first, const TTasks &... others) {
+            ptr_t tasks[] = {first, ptr_t(others)...};
+            return await_any_index(tasks, tasks + 1 + sizeof...(others));
         }
+#endif
 
         /**
          * @brief add next task to run when task finished
@@ -282,21 +684,16 @@ namespace cotask {
          * @return next_task if success , or self if failed
          */
         inline ptr_t next(ptr_t next_task, void *priv_data = UTIL_CONFIG_NULLPTR) {
-            // can not refers to self
+            // can not refers to self, next_task is the same as ptr_t(this) here
             if (this == next_task.get()) {
-                return ptr_t(this);
+                return next_task;
             }
 
             // can not add next task when finished
-            if (is_exiting()) {
+            if (is_exiting() || !push_next_node(next_task, priv_data, 0, false)) {
                 return ptr_t(this);
             }
 
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-            util::lock::lock_holder<util::lock::spin_lock> lock_guard(next_list_lock_);
-#endif
-
-            next_list_.member_list_.push_back(std::make_pair(next_task, priv_data));
             return next_task;
         }
 
@@ -375,9 +772,17 @@ namespace cotask {
 
         /**
          * get current running task and convert to task object
-         * @return task smart pointer
+         * @note the type is checked by the type tag of the task, RTTI is not used
+         * @return current running task, or NULL if not in a task of this type
          */
-        static self_t *this_task() { return dynamic_cast<self_t *>(impl::task_impl::this_task()); }
+        static self_t *this_task() UTIL_CONFIG_NOEXCEPT {
+            impl::task_impl *ret = impl::task_impl::this_task();
+            if (UTIL_CONFIG_NULLPTR == ret || ret->get_type_id() != &impl::task_result_type_id<self_t>::value) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            return static_cast<self_t *>(ret);
+        }
 
     public:
         virtual ~task() {
@@ -387,6 +792,22 @@ namespace cotask {
                 kill(EN_TS_TIMEOUT);
             }
 
+            // release continuations which will never run
+            next_node_t *node = take_next_nodes();
+            while (UTIL_CONFIG_NULLPTR != node) {
+                next_node_t *next = node->next;
+                if (UTIL_CONFIG_NULLPTR != node->dispatch_fn) {
+                    dispatch_entry_t entry;
+                    entry.task            = UTIL_CONFIG_NULLPTR;
+                    entry.priv_data       = node->priv_data;
+                    entry.expected_status = EN_TS_INVALID;
+                    entry.dispatch_fn     = node->dispatch_fn;
+                    (*entry.dispatch_fn)(entry, false);
+                }
+                free_next_node(node);
+                node = next;
+            }
+
             // free resource
             id_allocator_t id_alloc_;
             id_alloc_.deallocate(id_);
@@ -397,17 +818,119 @@ namespace cotask {
 
         inline id_t get_id() const UTIL_CONFIG_NOEXCEPT { return id_; }
 
+        /**
+         * @brief check if this task is created by create_lazy, so its stack is allocated when it's started
+         */
+        inline bool is_lazy() const UTIL_CONFIG_NOEXCEPT { return UTIL_CONFIG_NULLPTR != lazy_stack_; }
+
+        /**
+         * @brief check if this task is created by create_stackless, so it runs a C++20 coroutine without stack
+         */
+        inline bool is_stackless() const UTIL_CONFIG_NOEXCEPT { return UTIL_CONFIG_NULLPTR != lazy_stack_ && lazy_stack_->stackless; }
+
+        /**
+         * @brief check if this task is created by create_inline, so its action runs on the stack of caller
+         */
+        inline bool is_inline() const UTIL_CONFIG_NOEXCEPT { return UTIL_CONFIG_NULLPTR != lazy_stack_ && lazy_stack_->run_inline; }
+
+        /**
+         * @brief let the task keep a reference to itself until it finishes, so no ptr_t is needed to keep it alive
+         * @note the reference is released when the task is done, canceled, killed or timeout, after the coroutine returned to
+         *       the caller of start() or resume(). nothing else is registered.
+         *       a detached task which is never started or killed is never released.
+         * @return 0 or error code
+         */
+        int detach() {
+            // hold the reference before it's visible, the task may finish in another thread at the same time
+            intrusive_ptr_add_ref(this);
+
+            uint32_t expected = EN_TDS_NONE;
+            if (likely(detach_state_.compare_exchange_strong(expected, EN_TDS_DETACHED, util::lock::memory_order_acq_rel,
+                                                             util::lock::memory_order_acquire))) {
+                return copp::COPP_EC_SUCCESS;
+            }
+
+            // it's finished or already detached, other references may be released at the same time, so release it in the
+            // same way and do not touch this task after that
+            int ret = EN_TDS_DETACHED == expected ? copp::COPP_EC_ALREADY_EXIST : copp::COPP_EC_ALREADY_FINISHED;
+            intrusive_ptr_release(this);
+            return ret;
+        }
+
+        /**
+         * @brief check if this task is detached and not finished
+         */
+        inline bool is_detached() const UTIL_CONFIG_NOEXCEPT { return EN_TDS_DETACHED == detach_state_.load(); }
+
+        /**
+         * @brief set if kill(), cancel() and timeout unwind the stack of an unfinished task in one resume
+         * @note when enabled, the pending yield() of this task throws copp::detail::forced_unwind, destructors on its stack run
+         *       and the code after yield() is not executed. A task which is not started yet finishes without running its action.
+         *       It's disabled by default, and the task will be resumed until it finishes.
+         * @param enabled true to unwind the stack when killed
+         */
+        inline void set_unwind_on_kill(bool enabled) UTIL_CONFIG_NOEXCEPT { unwind_on_kill_ = enabled; }
+
+        /**
+         * @brief check if kill(), cancel() and timeout unwind the stack of this task
+         * @see set_unwind_on_kill
+         */
+        inline bool is_unwind_on_kill() const UTIL_CONFIG_NOEXCEPT { return unwind_on_kill_; }
+
+        /**
+         * @brief get the result of a task created by create_with_result<TResult>
+         * @note the result is available after the action returned, it's usually read after await(), when_all() or by the next task
+         * @return address of the result, or NULL if the action did not return, is killed before returning, the result is taken,
+         *         or TResult is not the result type of the action
+         */
+        template <typename TResult>
+        inline TResult *get_result() UTIL_CONFIG_NOEXCEPT {
+            action_ptr_t action = _get_action();
+            if (UTIL_CONFIG_NULLPTR == action) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            return reinterpret_cast<TResult *>(action->get_result(&impl::task_result_type_id<TResult>::value));
+        }
+
+        template <typename TResult>
+        inline const TResult *get_result() const UTIL_CONFIG_NOEXCEPT {
+            return const_cast<self_t *>(this)->template get_result<TResult>();
+        }
+
+        /**
+         * @brief move the result out of a task created by create_with_result<TResult>, and destroy the stored one
+         * @param out where to move the result to
+         * @return true if the result is moved, or false if get_result<TResult>() returns NULL
+         */
+        template <typename TResult>
+        bool take_result(TResult &out) {
+            TResult *res = get_result<TResult>();
+            if (UTIL_CONFIG_NULLPTR == res) {
+                return false;
+            }
+
+            out = COPP_MACRO_STD_MOVE(*res);
+            _get_action()->reset_result();
+            return true;
+        }
+
     public:
         virtual int get_ret_code() const UTIL_CONFIG_OVERRIDE {
             if (!coroutine_obj_) {
-                return 0;
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+                if (is_stackless()) {
+                    return get_stackless_action()->get_ret_code();
+                }
+#endif
+                return UTIL_CONFIG_NULLPTR == lazy_stack_ ? 0 : lazy_stack_->ret_code;
             }
 
             return coroutine_obj_->get_ret_code();
         }
 
         virtual int start(void *priv_data, EN_TASK_STATUS expected_status = EN_TS_CREATED) UTIL_CONFIG_OVERRIDE {
-            if (!coroutine_obj_) {
+            if (!coroutine_obj_ && UTIL_CONFIG_NULLPTR == lazy_stack_) {
                 return copp::COPP_EC_NOT_INITED;
             }
 
@@ -422,15 +945,42 @@ namespace cotask {
                     return copp::COPP_EC_IS_RUNNING;
                 }
 
+                // only the awaited task can resume a parked task
+                if (unlikely(from_status == EN_TS_AWAITING && expected_status != EN_TS_AWAITING)) {
+                    return copp::COPP_EC_TASK_IS_AWAITING;
+                }
+
                 if (likely(_cas_status(from_status, EN_TS_RUNNING))) { // Atomic.CAS here
                     break;
                 }
             } while (true);
 
+            // the first start of a lazy task
+            if (unlikely(!coroutine_obj_) && !lazy_stack_->stackless && !lazy_stack_->run_inline) {
+                int res = bind_stack();
+                if (res < 0) {
+                    // still not started, it can be started again
+                    EN_TASK_STATUS running_status = EN_TS_RUNNING;
+                    while (EN_TS_RUNNING == running_status && !_cas_status(running_status, from_status)) {
+                    }
+                    return res;
+                }
+            }
+
             // use this smart ptr to avoid destroy of this
             // ptr_t protect_from_destroy(this);
 
-            int ret = coroutine_obj_->start(priv_data);
+            int ret = copp::COPP_EC_SUCCESS;
+            if (likely(coroutine_obj_)) {
+                ret = coroutine_obj_->start(priv_data);
+            } else if (lazy_stack_->run_inline) {
+                run_inline(priv_data);
+            }
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+            else {
+                ret = get_stackless_action()->run(this, &impl::task_result_type_id<self_t>::value, _stackless_owner_hooks(), priv_data);
+            }
+#endif
 
             from_status = EN_TS_RUNNING;
             if (is_completed()) { // Atomic.CAS here
@@ -445,13 +995,19 @@ namespace cotask {
                 return ret;
             }
 
+            EN_TASK_STATUS to_status = await_parking_ ? EN_TS_AWAITING : EN_TS_WAITING;
             while (true) {
                 if (from_status >= EN_TS_DONE) { // canceled or killed
                     _notify_finished(finish_priv_data_);
                     break;
                 }
 
-                if (likely(_cas_status(from_status, EN_TS_WAITING))) { // Atomic.CAS here
+                if (likely(_cas_status(from_status, to_status))) { // Atomic.CAS here
+                    // the awaited tasks can not wake this task if they're finished before this task is parked
+                    // it's already resumed by another thread if this start() failed
+                    if (EN_TS_AWAITING == to_status && 0 == await_pending(await_state_.load())) {
+                        start(priv_data, EN_TS_AWAITING);
+                    }
                     break;
                     // waiting
                 }
@@ -466,7 +1022,7 @@ namespace cotask {
 
         virtual int yield(void **priv_data) UTIL_CONFIG_OVERRIDE {
             if (!coroutine_obj_) {
-                return copp::COPP_EC_NOT_INITED;
+                return is_inline() ? copp::COPP_EC_TASK_IS_INLINE : copp::COPP_EC_NOT_INITED;
             }
 
             return coroutine_obj_->yield(priv_data);
@@ -516,7 +1072,13 @@ namespace cotask {
     public:
         virtual bool is_completed() const UTIL_CONFIG_NOEXCEPT UTIL_CONFIG_OVERRIDE {
             if (!coroutine_obj_) {
-                return false;
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+                if (is_stackless()) {
+                    return get_stackless_action()->is_finished();
+                }
+#endif
+                // lazy task which is finished and has released its stack, or is killed before started
+                return UTIL_CONFIG_NULLPTR != lazy_stack_ && (lazy_stack_->inline_finished || is_exiting());
             }
 
             return coroutine_obj_->is_finished();
@@ -552,44 +1114,422 @@ namespace cotask {
     private:
         task(const task &) UTIL_CONFIG_DELETED_FUNCTION;
 
-        void active_next_tasks() {
-            std::list<std::pair<ptr_t, void *> > next_list;
+        /**
+         * @brief allocate the stack of a lazy task and create its coroutine
+         * @return COPP_EC_SUCCESS or error code
+         */
+        int bind_stack() {
+            // copy the allocator, so it can be retried if failed
+            typename coroutine_t::allocator_type alloc(lazy_stack_->alloc);
+            lazy_runner_t runner;
+            runner.action = _get_action();
+
+            typename coroutine_t::ptr_t coroutine =
+                coroutine_t::create(typename coroutine_t::callback_t(runner), alloc, lazy_stack_->stack_size,
+                                    sizeof(impl::task_impl *) + lazy_stack_->private_buffer_size);
+            if (!coroutine) {
+                return copp::COPP_EC_ALLOC_STACK_FAILED;
+            }
+
+            *(reinterpret_cast<impl::task_impl **>(coroutine->get_private_buffer())) = this;
+            coroutine->set_flags(impl::task_impl::ext_coroutine_flag_t::EN_ECFT_COTASK);
+            coroutine_obj_ = coroutine;
+            return copp::COPP_EC_SUCCESS;
+        }
+
+        // run the action of an inline task on the stack of caller, this_task() returns it and there is no current coroutine
+        void run_inline(void *priv_data) {
+            struct inline_scope_t {
+                copp::coroutine_context *co;
+                impl::task_impl *task;
+                explicit inline_scope_t(impl::task_impl *t) {
+                    co   = copp::this_coroutine::exchange_coroutine(UTIL_CONFIG_NULLPTR);
+                    task = _exchange_inline_task(t);
+                }
+                ~inline_scope_t() {
+                    _exchange_inline_task(task);
+                    copp::this_coroutine::exchange_coroutine(co);
+                }
+            };
+
+            inline_scope_t scope(this);
+            lazy_stack_->ret_code        = (*_get_action())(priv_data);
+            lazy_stack_->inline_finished = true;
+        }
+
+        // await_state_ keeps generation of the current wait in the high 32 bits and number of pending tasks in the low 32 bits,
+        // so a finished task which is registered by an old wait can not wake this task.
+        static inline uint32_t await_pending(uint64_t state) UTIL_CONFIG_NOEXCEPT { return static_cast<uint32_t>(state); }
+        static inline uint32_t await_generation(uint64_t state) UTIL_CONFIG_NOEXCEPT { return static_cast<uint32_t>(state >> 32); }
+
+        // called when a task this task is waiting for is finished, return true if it's the last one
+        bool _await_notify(uint32_t generation) UTIL_CONFIG_NOEXCEPT {
+            uint64_t state = await_state_.load();
+            while (await_generation(state) == generation && await_pending(state) > 0) {
+                if (await_state_.compare_exchange_weak(state, state - 1)) { // Atomic.CAS here
+                    return 1 == await_pending(state);
+                }
+            }
+
+            return false;
+        }
+
+        // the head of continuations is set to this after they are taken by active_next_tasks()
+        static inline uintptr_t next_head_closed() UTIL_CONFIG_NOEXCEPT { return 1; }
+
+        // lock-free push, return false if continuations of this task are already taken
+        bool push_next_node(const ptr_t &task, void *priv_data, uint32_t await_generation, bool is_awaiter,
+                            void (*dispatch_fn)(dispatch_entry_t &, bool) = UTIL_CONFIG_NULLPTR) {
+            next_node_t *node         = UTIL_CONFIG_NULLPTR;
+            uint32_t     inline_empty = 0;
+            if (inline_next_used_.compare_exchange_strong(inline_empty, 1)) { // Atomic.CAS here
+                node = &inline_next_;
+            } else {
+                node = new next_node_t();
+            }
+
+            node->task             = task;
+            node->priv_data        = priv_data;
+            node->await_generation = await_generation;
+            node->is_awaiter       = is_awaiter;
+            node->dispatch_fn      = dispatch_fn;
+
+            uintptr_t head = next_head_.load(util::lock::memory_order_acquire);
+            do {
+                if (next_head_closed() == head) {
+                    free_next_node(node);
+                    return false;
+                }
+
+                node->next = reinterpret_cast<next_node_t *>(head);
+            } while (!next_head_.compare_exchange_weak(head, reinterpret_cast<uintptr_t>(node), util::lock::memory_order_acq_rel,
+                                                       util::lock::memory_order_acquire)); // Atomic.CAS here
+
+            return true;
+        }
+
+        // take all the continuations in order of adding, and no more continuation can be added
+        next_node_t *take_next_nodes() {
+            uintptr_t head = next_head_.exchange(next_head_closed(), util::lock::memory_order_acq_rel);
+            if (next_head_closed() == head) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            // it's a stack, reverse it
+            next_node_t *ret  = UTIL_CONFIG_NULLPTR;
+            next_node_t *node = reinterpret_cast<next_node_t *>(head);
+            while (UTIL_CONFIG_NULLPTR != node) {
+                next_node_t *next = node->next;
+                node->next        = ret;
+                ret               = node;
+                node              = next;
+            }
+
+            return ret;
+        }
+
+        void free_next_node(next_node_t *node) {
+            node->task.reset();
+            if (&inline_next_ != node) {
+                delete node;
+            }
+        }
+
+        // return false if continuations of this task are already taken, and the awaiter is not added
+        inline bool add_awaiter(const ptr_t &awaiter, uint32_t generation) { return push_next_node(awaiter, UTIL_CONFIG_NULLPTR, generation, true); }
+
+        // start a new wait for the tasks, return number of tasks this task is still waiting for
+        uint32_t await_register(const ptr_t *begin, const ptr_t *end, bool wait_all) {
+            uint32_t generation = await_generation(await_state_.load()) + 1;
+            uint64_t pending    = wait_all ? static_cast<uint64_t>(end - begin) : 1;
+            await_state_.store((static_cast<uint64_t>(generation) << 32) | pending);
+
+            ptr_t self(this);
+            for (const ptr_t *iter = begin; iter != end; ++iter) {
+                // count the finished tasks by self
+                if (!(*iter)->add_awaiter(self, generation) && _await_notify(generation)) {
+                    break;
+                }
+            }
+
+            return await_pending(await_state_.load());
+        }
+
+        // park this task until all of the tasks or any of them finished
+        int await_tasks(const ptr_t *begin, const ptr_t *end, bool wait_all) {
+            if (this_task() != this) {
+                return copp::COPP_EC_TASK_NOT_IN_ACTION;
+            }
+
+            // it can not be parked
+            if (is_inline()) {
+                return copp::COPP_EC_TASK_IS_INLINE;
+            }
+
+            if (is_exiting()) {
+                return copp::COPP_EC_TASK_IS_EXITING;
+            }
+
+            for (const ptr_t *iter = begin; iter != end; ++iter) {
+                if (!*iter) {
+                    return copp::COPP_EC_ARGS_ERROR;
+                }
+
+                if (this == iter->get()) {
+                    return copp::COPP_EC_TASK_CAN_NOT_WAIT_SELF;
+                }
+            }
+
+            await_register(begin, end, wait_all);
+
+            await_parking_ = true;
+            int ret        = copp::COPP_EC_SUCCESS;
+            while (await_pending(await_state_.load()) > 0) {
+                if (is_exiting()) {
+                    ret = copp::COPP_EC_TASK_IS_EXITING;
+                    break;
+                }
+
+                yield();
+            }
+            await_parking_ = false;
+
+            return ret;
+        }
+
+        int await_any_index(const ptr_t *begin, const ptr_t *end) {
+            int ret = await_tasks(begin, end, false);
+            if (ret < 0) {
+                return ret;
+            }
+
+            for (const ptr_t *iter = begin; iter != end; ++iter) {
+                if ((*iter)->is_exiting()) {
+                    return static_cast<int>(iter - begin);
+                }
+            }
+
+            return copp::COPP_EC_TASK_IS_EXITING;
+        }
+
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+        inline impl::task_action_stackless_base *get_stackless_action() const UTIL_CONFIG_NOEXCEPT {
+            return static_cast<impl::task_action_stackless_base *>(get_raw_action());
+        }
+
+        // called by task_awaiter in the coroutine of this stackless task, return false if it should not be suspended
+        bool _stackless_await(const ptr_t &wait_task) {
+            if (this == wait_task.get() || is_exiting()) {
+                return false;
+            }
+
+            if (0 == await_register(&wait_task, &wait_task + 1, true)) {
+                return false;
+            }
+
+            // parked by start() after the coroutine is suspended
+            await_parking_ = true;
+            return true;
+        }
+
+        int _stackless_await_resume() {
+            await_parking_ = false;
+            return is_exiting() ? copp::COPP_EC_TASK_IS_EXITING : copp::COPP_EC_SUCCESS;
+        }
+
+        static void dispatch_coroutine_handle(dispatch_entry_t &entry, bool run) {
+            if (run) {
+                std::coroutine_handle<>::from_address(entry.priv_data).resume();
+            }
+        }
+
+        // resume a C++20 coroutine which is not run by a task when wait_task finishes
+        static bool _push_coroutine_handle(const ptr_t &wait_task, void *handle_address) {
+            return wait_task->push_next_node(ptr_t(), handle_address, 0, false, dispatch_coroutine_handle);
+        }
+
+        struct stackless_owner_node_t {
+            impl::task_impl *                  owner;
+            const impl::stackless_owner_hooks *hooks;
+            uint32_t                           generation;
+        };
+
+        static void dispatch_stackless_owner(dispatch_entry_t &entry, bool run) {
+            stackless_owner_node_t *node = reinterpret_cast<stackless_owner_node_t *>(entry.priv_data);
+            (*node->hooks->await_notify)(node->owner, node->generation, run);
+            delete node;
+        }
+
+        // wake a stackless task of another type when wait_task finishes, return false if wait_task is already finished
+        static bool _push_stackless_owner(const ptr_t &wait_task, impl::task_impl *owner, const impl::stackless_owner_hooks *hooks,
+                                          uint32_t generation) {
+            stackless_owner_node_t *node = new stackless_owner_node_t();
+            node->owner                  = owner;
+            node->hooks                  = hooks;
+            node->generation             = generation;
+            if (!wait_task->push_next_node(ptr_t(), node, 0, false, dispatch_stackless_owner)) {
+                delete node;
+                return false;
+            }
 
-            // first, lock and swap container
-            {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(next_list_lock_);
+            return true;
+        }
+
+        static bool _stackless_hook_await_begin(impl::task_impl *owner, uint32_t *generation) {
+            self_t *self = static_cast<self_t *>(owner);
+            if (self->is_exiting()) {
+                return false;
+            }
+
+            *generation = await_generation(self->await_state_.load()) + 1;
+            self->await_state_.store((static_cast<uint64_t>(*generation) << 32) | 1);
+
+            // held by the continuation in the awaited task
+            intrusive_ptr_add_ref(self);
+            return true;
+        }
+
+        static void _stackless_hook_await_notify(impl::task_impl *owner, uint32_t generation, bool wake) {
+            ptr_t self(static_cast<self_t *>(owner), false);
+            if (self->_await_notify(generation) && wake) {
+                self->resume(UTIL_CONFIG_NULLPTR, EN_TS_AWAITING);
+            }
+        }
+
+        static void _stackless_hook_await_park(impl::task_impl *owner) { static_cast<self_t *>(owner)->await_parking_ = true; }
+
+        static int _stackless_hook_await_resume(impl::task_impl *owner) { return static_cast<self_t *>(owner)->_stackless_await_resume(); }
+
+        static const impl::stackless_owner_hooks *_stackless_owner_hooks() {
+            static const impl::stackless_owner_hooks hooks = {_stackless_hook_await_begin, _stackless_hook_await_notify,
+                                                              _stackless_hook_await_park, _stackless_hook_await_resume};
+            return &hooks;
+        }
 #endif
-                next_list.swap(next_list_.member_list_);
+
+        static void dispatch_next_task(dispatch_entry_t &entry, bool run) {
+            // take the reference held by the entry
+            ptr_t task(static_cast<self_t *>(entry.task), false);
+            if (!run || EN_TS_INVALID == task->get_status()) {
+                return;
+            }
+
+            if (EN_TS_AWAITING == entry.expected_status) {
+                task->resume(entry.priv_data, EN_TS_AWAITING);
+            } else if (task->get_status() < EN_TS_RUNNING) {
+                task->start(entry.priv_data);
+            } else {
+                task->resume(entry.priv_data);
+            }
+        }
+
+        void active_next_tasks() {
+            // first, take all the continuations
+            next_node_t *node = take_next_nodes();
+            if (UTIL_CONFIG_NULLPTR == node) {
+                return;
             }
 
+            EN_TASK_DISPATCH_MODE dispatch_mode = get_dispatch_mode();
+            dispatch_entry_t      entry;
+
             // then, do all the pending tasks
-            for (typename std::list<std::pair<ptr_t, void *> >::iterator iter = next_list.begin(); iter != next_list.end(); ++iter) {
-                if (!iter->first || EN_TS_INVALID == iter->first->get_status()) {
+            while (UTIL_CONFIG_NULLPTR != node) {
+                ptr_t        task;
+                void *       priv_data        = node->priv_data;
+                uint32_t     await_generation = node->await_generation;
+                bool         is_awaiter       = node->is_awaiter;
+                next_node_t *next             = node->next;
+                void (*dispatch_fn)(dispatch_entry_t &, bool) = node->dispatch_fn;
+                task.swap(node->task);
+                free_next_node(node);
+                node = next;
+
+                // C++20 coroutine which awaits this task
+                if (UTIL_CONFIG_NULLPTR != dispatch_fn) {
+                    entry.task            = UTIL_CONFIG_NULLPTR;
+                    entry.priv_data       = priv_data;
+                    entry.expected_status = EN_TS_INVALID;
+                    entry.dispatch_fn     = dispatch_fn;
+                    if (EN_TDM_INLINE != dispatch_mode) {
+                        _push_dispatch(entry);
+                    } else {
+                        (*dispatch_fn)(entry, true);
+                    }
+                    continue;
+                }
+
+                if (!task) {
+                    continue;
+                }
+
+                // the tasks parked by await() are woken only if this is the last one they are waiting for
+                if (is_awaiter && !task->_await_notify(await_generation)) {
+                    continue;
+                }
+
+                if (EN_TDM_INLINE != dispatch_mode) {
+                    entry.priv_data       = priv_data;
+                    entry.expected_status = is_awaiter ? EN_TS_AWAITING : EN_TS_INVALID;
+                    entry.dispatch_fn     = dispatch_next_task;
+                    entry.task            = task.detach();
+                    _push_dispatch(entry);
                     continue;
                 }
 
-                if (iter->first->get_status() < EN_TS_RUNNING) {
-                    iter->first->start(iter->second);
+                if (is_awaiter) {
+                    task->resume(priv_data, EN_TS_AWAITING);
+                } else if (EN_TS_INVALID == task->get_status()) {
+                    continue;
+                } else if (task->get_status() < EN_TS_RUNNING) {
+                    task->start(priv_data);
                 } else {
-                    iter->first->resume(iter->second);
+                    task->resume(priv_data);
                 }
             }
+
+            // the outermost dispatch runs all of them, the nested ones just return
+            if (EN_TDM_TRAMPOLINE == dispatch_mode) {
+                dispatch_pending();
+            }
         }
 
         int _notify_finished(void *priv_data) {
             // first, make sure coroutine finished.
             if (coroutine_obj_ && false == coroutine_obj_->is_finished()) {
+                // unwind all the stack in one resume
+                if (unwind_on_kill_) {
+                    coroutine_obj_->unwind(priv_data);
+                }
+
                 // make sure this task will not be destroyed when running
                 while (false == coroutine_obj_->is_finished()) {
                     coroutine_obj_->resume(priv_data);
                 }
             }
 
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+            // destroy the frame of the suspended coroutine
+            if (is_stackless()) {
+                get_stackless_action()->destroy_routine();
+            }
+#endif
+
             int ret = impl::task_impl::_notify_finished(priv_data);
 
+            // lazy task does not live on the stack, give the stack back to the allocator before next tasks use it
+            if (UTIL_CONFIG_NULLPTR != lazy_stack_ && coroutine_obj_ && coroutine_obj_->is_finished()) {
+                lazy_stack_->ret_code = coroutine_obj_->get_ret_code();
+                coroutine_obj_.reset();
+            }
+
             // next tasks
             active_next_tasks();
+
+            // release the reference of detach(), this task may be destroyed here
+            if (EN_TDS_DETACHED == detach_state_.exchange(EN_TDS_FINISHED, util::lock::memory_order_acq_rel)) {
+                intrusive_ptr_release(this);
+            }
             return ret;
         }
 
@@ -611,6 +1551,9 @@ namespace cotask {
             if (0 == left) {
                 // save coroutine context first, make sure it's still available after destroy task
                 typename coroutine_t::ptr_t coro = p->coroutine_obj_;
+                std::shared_ptr<recycler_t> recycler;
+                recycler.swap(p->recycler_);
+                lazy_stack_t *lazy_stack = p->lazy_stack_;
 
                 // then, find and destroy action
                 void *action_ptr = reinterpret_cast<void *>(p->_get_action());
@@ -621,6 +1564,17 @@ namespace cotask {
                 // then, destruct task
                 p->~task();
 
+                // lazy task is in the heap block allocated by create_lazy_with_delegate
+                if (UTIL_CONFIG_NULLPTR != lazy_stack) {
+                    lazy_stack->~lazy_stack_t();
+                    ::operator delete(reinterpret_cast<void *>(p));
+                }
+
+                // give the coroutine to task_pool, which may keep it for the next task
+                if (recycler && coro) {
+                    recycler->recycle(coro);
+                }
+
                 // at last, destroy the coroutine and maybe recycle the stack space
                 coro.reset();
             }
@@ -629,18 +1583,38 @@ namespace cotask {
     private:
         id_t                        id_;
         typename coroutine_t::ptr_t coroutine_obj_;
-        task_group                  next_list_;
+        next_node_t                 inline_next_;
 
         // ============== action information ==============
         void (*action_destroy_fn_)(void *);
+        bool unwind_on_kill_;
+        std::shared_ptr<recycler_t> recycler_;
+        lazy_stack_t *lazy_stack_;
+        bool await_parking_; // set by await_tasks(), park this task when it yields
+
+        enum EN_TASK_DETACH_STATE {
+            EN_TDS_NONE     = 0,
+            EN_TDS_DETACHED = 1, // holds a reference to itself
+            EN_TDS_FINISHED = 2, // finished, detach() does nothing
+        };
 
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-        util::lock::atomic_int_type<size_t> ref_count_; /** ref_count **/
-        util::lock::spin_lock               next_list_lock_;
-#else
-        util::lock::atomic_int_type<util::lock::unsafe_int_type<size_t> > ref_count_; /** ref_count **/
-#endif
+        typename thread_policy_t::template atomic_type<size_t>::type ref_count_; /** ref_count **/
+        typename thread_policy_t::template atomic_type<uint64_t>::type await_state_; /** generation and pending number of await_tasks() **/
+        typename thread_policy_t::template atomic_type<uintptr_t>::type next_head_; /** stack of continuations **/
+        typename thread_policy_t::template atomic_type<uint32_t>::type inline_next_used_; /** if inline_next_ is taken **/
+        typename thread_policy_t::template atomic_type<uint32_t>::type detach_state_; /** EN_TASK_DETACH_STATE **/
     };
+
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+    /**
+     * @brief co_await a task in C++20 coroutines
+     * @see task_awaiter
+     */
+    template <typename TCO_MACRO, typename TTASK_MACRO>
+    inline task_awaiter<task<TCO_MACRO, TTASK_MACRO> > operator co_await(const std::intrusive_ptr<task<TCO_MACRO, TTASK_MACRO> > &t) {
+        return task_awaiter<task<TCO_MACRO, TTASK_MACRO> >(t);
+    }
+#endif
 } // namespace cotask
 
 
@@ -10,7 +10,12 @@
 #ifndef COTASK_TASK_ACTIONS_H
 #define COTASK_TASK_ACTIONS_H
 
-#pragma once
+#pragma once
+
+#include <new>
+#include <type_traits>
+
+#include <libcopp/utils/features.h>
 
 #include <libcotask/impl/task_action_impl.h>
 
@@ -206,6 +211,62 @@ namespace cotask {
         value_type func_;
     };
 
+    // functor which returns a result, the result is stored in the action
+    template <typename TResult, typename Ty>
+    class task_action_result : public impl::task_action_impl {
+    public:
+        typedef TResult result_type;
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        typedef typename std::remove_cv<typename std::remove_reference<Ty>::type>::type value_type;
+
+        task_action_result(value_type &&functor) : functor_(std::move(functor)), has_result_(false) {}
+        task_action_result(const value_type &functor) : functor_(functor), has_result_(false) {}
+#else
+        typedef Ty value_type;
+        task_action_result(const value_type &functor) : functor_(functor), has_result_(false) {}
+#endif
+        ~task_action_result() { reset_result(); }
+
+        virtual int operator()(void* priv_data) {
+            reset_result();
+            new (&result_) result_type(functor_(priv_data));
+            has_result_ = true;
+            return 0;
+        }
+
+        virtual void *get_result(const void *type_id) {
+            if (!has_result_ || type_id != &impl::task_result_type_id<result_type>::value) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            return &result_;
+        }
+
+        virtual void reset_result() {
+            if (has_result_) {
+                has_result_ = false;
+                reinterpret_cast<result_type *>(&result_)->~result_type();
+            }
+        }
+
+        static void placement_destroy(void* selfp) {
+            if (UTIL_CONFIG_NULLPTR == selfp) {
+                return;
+            }
+
+            task_action_result<TResult, Ty>* self = reinterpret_cast<task_action_result<TResult, Ty>*>(selfp);
+            self->~task_action_result();
+        }
+
+    private:
+        task_action_result(const task_action_result &) UTIL_CONFIG_DELETED_FUNCTION;
+        task_action_result &operator=(const task_action_result &) UTIL_CONFIG_DELETED_FUNCTION;
+
+        value_type functor_;
+        typename std::aligned_storage<sizeof(result_type), std::alignment_of<result_type>::value>::type result_;
+        bool has_result_;
+    };
+
     template <typename Ty>
     void placement_destroy(void* selfp) {
         if (UTIL_CONFIG_NULLPTR == selfp) {
@@ -228,6 +289,11 @@ namespace cotask {
         return &task_action_function<Ty>::placement_destroy;
     }
 
+    template <typename TResult, typename Ty>
+    placement_destroy_fn_t get_placement_destroy(task_action_result<TResult, Ty>* selfp) {
+        return &task_action_result<TResult, Ty>::placement_destroy;
+    }
+
     template <typename Ty, typename Tc>
     placement_destroy_fn_t get_placement_destroy(task_action_mem_function<Ty, Tc>* selfp) {
         return &task_action_mem_function<Ty, Tc>::placement_destroy;
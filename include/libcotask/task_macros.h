@@ -10,16 +10,19 @@
 #ifndef COTASK_TASK_MACROS_H
 #define COTASK_TASK_MACROS_H
 
-#pragma once
+#pragma once
 
 #include <stdint.h>
 
 #include <libcopp/coroutine/coroutine_context_container.h>
 #include <libcopp/utils/errno.h>
 #include <libcopp/utils/features.h>
+#include <libcopp/utils/thread_policy.h>
 
 
 #include "libcotask/core/standard_int_id_allocator.h"
+#include "libcotask/core/standard_int_id_block_allocator.h"
+#include "libcotask/core/standard_int_id_slot_allocator.h"
 #include <libcotask/core/standard_new_allocator.h>
 #include <libcotask/impl/task_impl.h>
 
@@ -27,12 +30,34 @@
 namespace cotask {
     struct macro_coroutine {
         typedef copp::allocator::default_statck_allocator stack_allocator_t;
-        typedef copp::coroutine_context_container<stack_allocator_t> coroutine_t;
+        typedef util::lock::default_thread_policy thread_policy_t;
+        typedef copp::coroutine_context_container<stack_allocator_t, thread_policy_t> coroutine_t;
     };
 
     struct macro_task {
         typedef uint64_t id_t;
-        typedef core::standard_int_id_allocator<uint64_t> id_allocator_t;
+        typedef core::standard_int_id_block_allocator<uint64_t> id_allocator_t;
+        typedef util::lock::default_thread_policy thread_policy_t;
+    };
+
+    // task ids are generational handles, used with task_slot_map
+    struct macro_task_slot {
+        typedef uint64_t id_t;
+        typedef core::standard_int_id_slot_allocator<uint64_t> id_allocator_t;
+        typedef util::lock::default_thread_policy thread_policy_t;
+    };
+
+    // tasks and coroutines which are only used in the thread creating them, nothing is synchronized
+    struct macro_coroutine_single_thread {
+        typedef copp::allocator::default_statck_allocator stack_allocator_t;
+        typedef util::lock::single_thread_policy thread_policy_t;
+        typedef copp::coroutine_context_container<stack_allocator_t, thread_policy_t> coroutine_t;
+    };
+
+    struct macro_task_single_thread {
+        typedef uint64_t id_t;
+        typedef core::standard_int_id_block_allocator<uint64_t> id_allocator_t;
+        typedef util::lock::single_thread_policy thread_policy_t;
     };
 }
 
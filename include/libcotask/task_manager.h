@@ -51,6 +51,7 @@ namespace cotask {
 
     /**
      * @brief task manager
+     * @note the lock is decided by the thread policy of TTask, it does nothing for single_thread_policy
      */
     template <typename TTask, typename TTaskContainer = std::map<typename TTask::id_t, task_mgr_node<TTask> > >
     class task_manager {
@@ -59,6 +60,7 @@ namespace cotask {
         typedef TTaskContainer                    container_t;
         typedef typename task_t::id_t             id_t;
         typedef typename task_t::ptr_t            task_ptr_t;
+        typedef typename task_t::thread_policy_t  thread_policy_t;
         typedef task_manager<task_t, container_t> self_t;
         typedef std::shared_ptr<self_t>           ptr_t;
 
@@ -111,9 +113,7 @@ namespace cotask {
             std::vector<task_ptr_t> all_tasks;
             // first, lock and reset all data
             {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 for (typename container_t::iterator iter = tasks_.begin(); iter != tasks_.end(); ++iter) {
                     all_tasks.push_back(iter->second.task_);
@@ -174,9 +174,7 @@ namespace cotask {
             }
 
                 // lock before we will operator tasks_
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-            util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
             id_t task_id = task->get_id();
             if (tasks_.end() != tasks_.find(task_id)) {
@@ -219,9 +217,7 @@ namespace cotask {
 
             task_ptr_t task_inst;
             {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 typedef typename container_t::iterator iter_type;
                 iter_type                              iter = tasks_.find(id);
@@ -252,9 +248,7 @@ namespace cotask {
                 return task_ptr_t();
             }
 
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-            util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
             typedef typename container_t::iterator iter_type;
             iter_type                              iter = tasks_.find(id);
@@ -274,9 +268,7 @@ namespace cotask {
 
             task_ptr_t task_inst;
             {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 typedef typename container_t::iterator iter_type;
                 iter_type                              iter = tasks_.find(id);
@@ -292,9 +284,7 @@ namespace cotask {
                 // if task is finished, remove it
                 if (task_inst->get_status() >= EN_TS_DONE) {
                 // lock again and prepare to remove from tasks_
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                    util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                    util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
                     tasks_.erase(id);
                 }
 
@@ -311,9 +301,7 @@ namespace cotask {
 
             task_ptr_t task_inst;
             {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 typedef typename container_t::iterator iter_type;
                 iter_type                              iter = tasks_.find(id);
@@ -329,9 +317,7 @@ namespace cotask {
                 // if task is finished, remove it
                 if (task_inst->get_status() >= EN_TS_DONE) {
                 // lock again and prepare to remove from tasks_
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                    util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                    util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
                     tasks_.erase(id);
                 }
 
@@ -348,9 +334,7 @@ namespace cotask {
 
             task_ptr_t task_inst;
             {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 typedef typename container_t::iterator iter_type;
                 iter_type                              iter = tasks_.find(id);
@@ -377,9 +361,7 @@ namespace cotask {
 
             task_ptr_t task_inst;
             {
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 typedef typename container_t::iterator iter_type;
                 iter_type                              iter = tasks_.find(id);
@@ -427,9 +409,7 @@ namespace cotask {
             // first tick, init and reset task timeout
             if (0 == last_tick_time_.tv_sec && 0 == last_tick_time_.tv_nsec) {
             // hold lock
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                 std::multimap<detail::tickspec_t, id_t> real_checkpoints;
                 for (typename std::multimap<detail::tickspec_t, id_t>::iterator iter = task_timeout_checkpoints_.begin();
@@ -452,9 +432,7 @@ namespace cotask {
 
                 {
                 // hold lock
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-                    util::lock::lock_holder<util::lock::spin_lock> lock_guard(action_lock_);
-#endif
+                    util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
 
                     typename std::multimap<detail::tickspec_t, id_t>::value_type &task_node = *task_timeout_checkpoints_.begin();
                     // all tasks those expired time less than now are timeout
@@ -522,9 +500,7 @@ namespace cotask {
         detail::tickspec_t                      last_tick_time_;
         std::multimap<detail::tickspec_t, id_t> task_timeout_checkpoints_;
 
-#if !defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)
-        util::lock::spin_lock action_lock_;
-#endif
+        typename thread_policy_t::lock_type action_lock_;
         int flags_;
     };
 } // namespace cotask
@@ -0,0 +1,173 @@
+/*
+ * task_pool.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COTASK_TASK_POOL_H
+#define COTASK_TASK_POOL_H
+
+#pragma once
+
+#include <vector>
+
+#include <libcopp/utils/features.h>
+#include <libcopp/utils/lock_holder.h>
+#include <libcopp/utils/thread_policy.h>
+#include <libcopp/utils/std/smart_ptr.h>
+
+#include <libcotask/task.h>
+
+namespace cotask {
+
+    /**
+     * @brief recycle tasks of the same action type
+     * @note A released task gives its coroutine back to the pool instead of freeing it. The next task created by the pool
+     *       reuses the stack, the coroutine container and the space of task and action on it, and its runner is still bound
+     *       to the same action address, so nothing is allocated for the task. The task and the action are constructed in
+     *       place again, and the task gets a new id.
+     *       Tasks keep the pool alive, so the pool can be released before them.
+     * @see task::create
+     */
+    template <typename TAct, typename TCO_MACRO = macro_coroutine, typename TTASK_MACRO = macro_task>
+    class task_pool : public task<TCO_MACRO, TTASK_MACRO>::recycler_t,
+                      public std::enable_shared_from_this<task_pool<TAct, TCO_MACRO, TTASK_MACRO> > {
+    public:
+        typedef task_pool<TAct, TCO_MACRO, TTASK_MACRO> self_t;
+        typedef std::shared_ptr<self_t> ptr_t;
+        typedef task<TCO_MACRO, TTASK_MACRO> task_t;
+        typedef typename task_t::ptr_t task_ptr_t;
+        typedef typename task_t::thread_policy_t thread_policy_t;
+        typedef typename task_t::coroutine_t coroutine_t;
+        typedef typename coroutine_t::allocator_type allocator_type;
+        typedef typename std::conditional<std::is_base_of<impl::task_action_impl, TAct>::value, TAct, task_action_functor<TAct> >::type
+            action_t;
+
+    private:
+        struct constructor_delegator {};
+
+        task_pool(const task_pool &) UTIL_CONFIG_DELETED_FUNCTION;
+
+    public:
+        /**
+         * @brief create a task pool
+         * @param stack_size stack size of tasks
+         * @param private_buffer_size private buffer size of tasks
+         * @param max_free_number max number of cached coroutines, 0 means no limit
+         * @return task pool
+         */
+        static ptr_t create(size_t stack_size = 0, size_t private_buffer_size = 0, size_t max_free_number = 0) {
+            ptr_t ret = std::make_shared<self_t>(constructor_delegator());
+            if (ret) {
+                ret->stack_size_ = stack_size;
+                ret->private_buffer_size_ = private_buffer_size;
+                ret->max_free_number_ = max_free_number;
+            }
+
+            return ret;
+        }
+
+        task_pool(constructor_delegator) : stack_size_(0), private_buffer_size_(0), max_free_number_(0) {}
+        ~task_pool() { clear(); }
+
+        inline allocator_type &get_allocator() UTIL_CONFIG_NOEXCEPT { return alloc_; }
+        inline const allocator_type &get_allocator() const UTIL_CONFIG_NOEXCEPT { return alloc_; }
+
+        inline size_t get_stack_size() const UTIL_CONFIG_NOEXCEPT { return stack_size_; }
+        inline size_t get_private_buffer_size() const UTIL_CONFIG_NOEXCEPT { return private_buffer_size_; }
+
+        inline void set_max_free_number(size_t v) UTIL_CONFIG_NOEXCEPT { max_free_number_ = v; }
+        inline size_t get_max_free_number() const UTIL_CONFIG_NOEXCEPT { return max_free_number_; }
+
+        /**
+         * @brief get number of cached coroutines
+         */
+        size_t get_free_number() const {
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
+            return free_list_.size();
+        }
+
+        /**
+         * @brief free all cached coroutines
+         */
+        void clear() {
+            std::vector<typename coroutine_t::ptr_t> free_list;
+            {
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
+                free_list.swap(free_list_);
+            }
+        }
+
+/**
+ * @brief create task with functor, reuse a cached coroutine if there is one
+ * @param functor functor or action object of type TAct
+ * @return task smart pointer
+ */
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+        template <typename Ty>
+        task_ptr_t create_task(Ty &&functor) {
+#else
+        template <typename Ty>
+        task_ptr_t create_task(const Ty &functor) {
+#endif
+            typename coroutine_t::ptr_t coroutine;
+            {
+                util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
+                if (!free_list_.empty()) {
+                    coroutine.swap(free_list_.back());
+                    free_list_.pop_back();
+                }
+            }
+
+            bool set_runner = false;
+            if (!coroutine) {
+                allocator_type alloc(alloc_);
+                coroutine = task_t::template create_coroutine<action_t>(alloc, stack_size_, private_buffer_size_);
+                if (!coroutine) {
+                    return task_ptr_t();
+                }
+                set_runner = true;
+            }
+
+            task_ptr_t ret = task_t::template create_on_coroutine<action_t>(coroutine, COPP_MACRO_STD_FORWARD(Ty, functor), set_runner);
+            if (ret) {
+                ret->recycler_ = this->shared_from_this();
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief called when a task created by this pool is released
+         * @param coroutine coroutine of the task, it's taken if it can be reused
+         */
+        virtual void recycle(typename coroutine_t::ptr_t &coroutine) UTIL_CONFIG_OVERRIDE {
+            // the task is not started or finished, so the coroutine can be restarted in place
+            if (coroutine->restart() < 0) {
+                return;
+            }
+
+            util::lock::lock_holder<typename thread_policy_t::lock_type> lock_guard(action_lock_);
+            if (0 != max_free_number_ && free_list_.size() >= max_free_number_) {
+                return;
+            }
+
+            free_list_.push_back(typename coroutine_t::ptr_t());
+            free_list_.back().swap(coroutine);
+        }
+
+    private:
+        allocator_type alloc_;
+        size_t stack_size_;
+        size_t private_buffer_size_;
+        size_t max_free_number_;
+        std::vector<typename coroutine_t::ptr_t> free_list_;
+
+        mutable typename thread_policy_t::lock_type action_lock_;
+    };
+} // namespace cotask
+
+#endif
@@ -0,0 +1,199 @@
+﻿/*
+ * task_slot_map.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COTASK_TASK_SLOT_MAP_H
+#define COTASK_TASK_SLOT_MAP_H
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <libcotask/core/standard_int_id_slot_allocator.h>
+#include <libcotask/task_manager.h>
+
+namespace cotask {
+
+    /**
+     * @brief container of task_manager which use the slot index of task id as array index
+     * @note task ids must be allocated by core::standard_int_id_slot_allocator, see macro_task_slot.
+     *       lookup is a array index and a id check, stale ids of destroyed tasks are never found.
+     *       the array grows to the max slot index of inserted ids, slot indexes are shared by all tasks which use the
+     *       same id allocator, so a small container of a busy process may be as large as the number of its living tasks.
+     * @example task_manager<task<macro_coroutine, macro_task_slot>, task_slot_map<task<macro_coroutine, macro_task_slot> > >
+     */
+    template <typename TTask>
+    class task_slot_map {
+    public:
+        typedef TTask                            task_t;
+        typedef typename task_t::id_t            key_type;
+        typedef typename task_t::id_allocator_t  id_allocator_t;
+        typedef task_mgr_node<task_t>            mapped_type;
+        typedef std::pair<key_type, mapped_type> value_type;
+        typedef size_t                           size_type;
+
+        UTIL_CONFIG_STATIC_ASSERT_MSG((std::is_same<id_allocator_t, core::standard_int_id_slot_allocator<key_type> >::value),
+                                      "task_slot_map requires task ids allocated by standard_int_id_slot_allocator");
+
+    private:
+        typedef std::vector<value_type> slots_t;
+
+        template <typename TSlots, typename TValue>
+        class basic_iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef typename std::remove_const<TValue>::type value_type;
+            typedef std::ptrdiff_t                            difference_type;
+            typedef TValue *                                  pointer;
+            typedef TValue &                                  reference;
+
+            basic_iterator() : slots_(UTIL_CONFIG_NULLPTR), index_(0) {}
+            basic_iterator(TSlots *slots, size_t index) : slots_(slots), index_(index) { skip_empty(); }
+
+            // iterator can be converted to const_iterator
+            template <typename TOtherSlots, typename TOtherValue>
+            basic_iterator(const basic_iterator<TOtherSlots, TOtherValue> &other,
+                           typename std::enable_if<std::is_const<TValue>::value && !std::is_const<TOtherValue>::value>::type * = 0)
+                : slots_(other.slots_), index_(other.index_) {}
+
+            inline reference operator*() const { return (*slots_)[index_]; }
+            inline pointer   operator->() const { return &(*slots_)[index_]; }
+
+            inline basic_iterator &operator++() {
+                ++index_;
+                skip_empty();
+                return *this;
+            }
+
+            inline basic_iterator operator++(int) {
+                basic_iterator ret = *this;
+                ++(*this);
+                return ret;
+            }
+
+            friend inline bool operator==(const basic_iterator &l, const basic_iterator &r) { return l.index_ == r.index_; }
+            friend inline bool operator!=(const basic_iterator &l, const basic_iterator &r) { return l.index_ != r.index_; }
+
+        private:
+            template <typename, typename>
+            friend class basic_iterator;
+            friend class task_slot_map;
+
+            inline void skip_empty() {
+                while (UTIL_CONFIG_NULLPTR != slots_ && index_ < slots_->size() && id_allocator_t::npos == (*slots_)[index_].first) {
+                    ++index_;
+                }
+            }
+
+            TSlots *slots_;
+            size_t  index_;
+        };
+
+    public:
+        typedef basic_iterator<slots_t, value_type>             iterator;
+        typedef basic_iterator<const slots_t, const value_type> const_iterator;
+
+        task_slot_map() : size_(0) {}
+
+        inline iterator       begin() { return iterator(&slots_, 0); }
+        inline iterator       end() { return iterator(&slots_, slots_.size()); }
+        inline const_iterator begin() const { return const_iterator(&slots_, 0); }
+        inline const_iterator end() const { return const_iterator(&slots_, slots_.size()); }
+
+        inline size_type size() const UTIL_CONFIG_NOEXCEPT { return size_; }
+        inline bool      empty() const UTIL_CONFIG_NOEXCEPT { return 0 == size_; }
+
+        iterator find(const key_type &key) {
+            size_t index = static_cast<size_t>(id_allocator_t::get_index(key));
+            if (id_allocator_t::npos == key || index >= slots_.size() || slots_[index].first != key) {
+                return end();
+            }
+
+            return iterator(&slots_, index);
+        }
+
+        const_iterator find(const key_type &key) const {
+            size_t index = static_cast<size_t>(id_allocator_t::get_index(key));
+            if (id_allocator_t::npos == key || index >= slots_.size() || slots_[index].first != key) {
+                return end();
+            }
+
+            return const_iterator(&slots_, index);
+        }
+
+        /**
+         * @brief get task by id without copying the smart pointer
+         * @param key task id
+         * @return task or NULL if not found
+         */
+        task_t *get_task(const key_type &key) const {
+            const_iterator iter = find(key);
+            if (end() == iter) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            return iter->second.task_.get();
+        }
+
+        std::pair<iterator, bool> insert(const value_type &value) {
+            if (id_allocator_t::npos == value.first) {
+                return std::pair<iterator, bool>(end(), false);
+            }
+
+            size_t index = static_cast<size_t>(id_allocator_t::get_index(value.first));
+            if (index >= slots_.size()) {
+                slots_.resize(index + 1);
+            }
+
+            // the slot is used by a living task
+            if (id_allocator_t::npos != slots_[index].first) {
+                return std::pair<iterator, bool>(iterator(&slots_, index), false);
+            }
+
+            slots_[index] = value;
+            ++size_;
+            return std::pair<iterator, bool>(iterator(&slots_, index), true);
+        }
+
+        void erase(iterator iter) {
+            if (end() == iter) {
+                return;
+            }
+
+            value_type &slot = *iter;
+            slot.first       = id_allocator_t::npos;
+            slot.second      = mapped_type();
+            --size_;
+        }
+
+        size_type erase(const key_type &key) {
+            iterator iter = find(key);
+            if (end() == iter) {
+                return 0;
+            }
+
+            erase(iter);
+            return 1;
+        }
+
+        void clear() {
+            slots_.clear();
+            size_ = 0;
+        }
+
+    private:
+        slots_t   slots_;
+        size_type size_;
+    };
+} // namespace cotask
+
+#endif /* COTASK_TASK_SLOT_MAP_H */
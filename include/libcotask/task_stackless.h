@@ -0,0 +1,284 @@
+/*
+ * task_stackless.h
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#ifndef COTASK_TASK_STACKLESS_H
+#define COTASK_TASK_STACKLESS_H
+
+#pragma once
+
+#include <libcopp/utils/features.h>
+
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+
+#include <coroutine>
+#include <exception>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#include <libcopp/utils/errno.h>
+
+#include <libcotask/impl/task_action_impl.h>
+
+namespace cotask {
+
+    namespace impl {
+        /**
+         * @brief functions of the task running a stackless routine, used when it awaits a task of another type
+         * @note the owner is parked like await() by these hooks, and it's always resumed by itself
+         */
+        struct stackless_owner_hooks {
+            // start a wait for one task and keep a reference of the owner, return false if it can not wait
+            bool (*await_begin)(task_impl *owner, uint32_t *generation);
+            // the awaited task is finished, wake the owner if wake is true, and release the reference
+            void (*await_notify)(task_impl *owner, uint32_t generation, bool wake);
+            // park the owner after the routine is suspended
+            void (*await_park)(task_impl *owner);
+            // return value of co_await
+            int (*await_resume)(task_impl *owner);
+        };
+    } // namespace impl
+
+    /**
+     * @brief return type of C++20 coroutines run by stackless tasks
+     * @note the coroutine is suspended when it's created, and it returns the return code of the task by co_return.
+     *       co_await std::suspend_always{} works like yield() of stackful tasks, and co_await a task pointer suspends
+     *       it until the task finished.
+     * @see task::create_stackless
+     */
+    class stackless_routine {
+    public:
+        struct promise_type {
+            promise_type() : ret_code(0), owner(UTIL_CONFIG_NULLPTR), owner_type(UTIL_CONFIG_NULLPTR), owner_hooks(UTIL_CONFIG_NULLPTR) {}
+
+            stackless_routine get_return_object() { return stackless_routine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() UTIL_CONFIG_NOEXCEPT { return std::suspend_always(); }
+
+            // keep the frame, the return code is read by the task after the coroutine finished
+            std::suspend_always final_suspend() UTIL_CONFIG_NOEXCEPT { return std::suspend_always(); }
+
+            void return_value(int v) { ret_code = v; }
+
+            // exceptions can not leave stackful tasks either
+            void unhandled_exception() { std::terminate(); }
+
+            int ret_code;
+            impl::task_impl *owner;   // the task running this coroutine
+            const void *owner_type; // address of impl::task_result_type_id<task type>::value
+            const impl::stackless_owner_hooks *owner_hooks; // hooks of the owner, to await tasks of other types
+        };
+
+        typedef std::coroutine_handle<promise_type> handle_t;
+
+        stackless_routine(stackless_routine &&other) : handle_(other.handle_) { other.handle_ = UTIL_CONFIG_NULLPTR; }
+        ~stackless_routine() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        /**
+         * @brief give up the ownership of the coroutine frame
+         */
+        handle_t release() UTIL_CONFIG_NOEXCEPT {
+            handle_t ret = handle_;
+            handle_      = UTIL_CONFIG_NULLPTR;
+            return ret;
+        }
+
+    private:
+        explicit stackless_routine(handle_t h) : handle_(h) {}
+        stackless_routine(const stackless_routine &) UTIL_CONFIG_DELETED_FUNCTION;
+        stackless_routine &operator=(const stackless_routine &) UTIL_CONFIG_DELETED_FUNCTION;
+
+        handle_t handle_;
+    };
+
+    namespace impl {
+        /**
+         * @brief action of stackless tasks, it owns the coroutine frame and resumes it in start() and resume() of the task
+         */
+        class task_action_stackless_base : public task_action_impl {
+        public:
+            task_action_stackless_base() : ret_code_(0), finished_(false) {}
+            virtual ~task_action_stackless_base() { destroy_routine(); }
+
+            // run the routine without any task, co_await in it does not work with tasks
+            virtual int operator()(void *priv_data) { return run(UTIL_CONFIG_NULLPTR, UTIL_CONFIG_NULLPTR, UTIL_CONFIG_NULLPTR, priv_data); }
+
+            /**
+             * @brief create the routine in the first call, and resume it until it's suspended or finished
+             * @param owner the task running this routine
+             * @param owner_type address of task_result_type_id<task type>::value
+             * @param owner_hooks hooks of the owner, used when the routine awaits tasks of other types
+             * @param priv_data passed to the functor which creates the routine
+             * @return 0 or error code
+             */
+            int run(task_impl *owner, const void *owner_type, const stackless_owner_hooks *owner_hooks, void *priv_data) {
+                if (finished_) {
+                    return copp::COPP_EC_ALREADY_FINISHED;
+                }
+
+                if (!handle_) {
+                    handle_ = create_routine(priv_data).release();
+                    if (!handle_) {
+                        finished_ = true;
+                        return copp::COPP_EC_NOT_INITED;
+                    }
+
+                    handle_.promise().owner       = owner;
+                    handle_.promise().owner_type  = owner_type;
+                    handle_.promise().owner_hooks = owner_hooks;
+                }
+
+                handle_.resume();
+
+                // release the frame as soon as it finished, like lazy tasks release their stacks
+                if (handle_.done()) {
+                    ret_code_ = handle_.promise().ret_code;
+                    destroy_routine();
+                }
+
+                return copp::COPP_EC_SUCCESS;
+            }
+
+            /**
+             * @brief destroy the frame of a suspended routine, destructors of its local variables are called
+             */
+            void destroy_routine() {
+                if (handle_) {
+                    handle_.destroy();
+                    handle_ = UTIL_CONFIG_NULLPTR;
+                }
+                finished_ = true;
+            }
+
+            inline bool is_finished() const UTIL_CONFIG_NOEXCEPT { return finished_; }
+            inline int get_ret_code() const UTIL_CONFIG_NOEXCEPT { return ret_code_; }
+
+        protected:
+            virtual stackless_routine create_routine(void *priv_data) = 0;
+
+        private:
+            stackless_routine::handle_t handle_;
+            int ret_code_;
+            bool finished_;
+        };
+    } // namespace impl
+
+    // functor which returns a stackless_routine
+    template <typename Ty>
+    class task_action_stackless : public impl::task_action_stackless_base {
+    public:
+        typedef typename std::remove_cv<typename std::remove_reference<Ty>::type>::type value_type;
+
+        task_action_stackless(value_type &&functor) : functor_(std::move(functor)) {}
+        task_action_stackless(const value_type &functor) : functor_(functor) {}
+
+        static void placement_destroy(void *selfp) {
+            if (UTIL_CONFIG_NULLPTR == selfp) {
+                return;
+            }
+
+            task_action_stackless<Ty> *self = reinterpret_cast<task_action_stackless<Ty> *>(selfp);
+            self->~task_action_stackless();
+        }
+
+    protected:
+        virtual stackless_routine create_routine(void *priv_data) { return functor_(priv_data); }
+
+    private:
+        value_type functor_;
+    };
+
+    /**
+     * @brief co_await a task in C++20 coroutines
+     * @note If the coroutine is run by a stackless task, the task is parked with status EN_TS_AWAITING like await(), and
+     *       it's woken by the awaited task, which may be of another type. Otherwise, the coroutine is resumed by the
+     *       awaited task when it finishes, in the way next tasks are dispatched.
+     *       If the awaited task is released without finishing, the coroutine is never resumed.
+     * @return 0 when the awaited task is finished, or error code
+     */
+    template <typename TTask>
+    class task_awaiter {
+    public:
+        typedef typename TTask::ptr_t ptr_t;
+
+        explicit task_awaiter(const ptr_t &t)
+            : task_(t), owner_(UTIL_CONFIG_NULLPTR), foreign_owner_(UTIL_CONFIG_NULLPTR), foreign_hooks_(UTIL_CONFIG_NULLPTR) {}
+
+        bool await_ready() const UTIL_CONFIG_NOEXCEPT { return !task_ || task_->is_exiting() || task_->is_completed(); }
+
+        bool await_suspend(std::coroutine_handle<stackless_routine::promise_type> handle) {
+            stackless_routine::promise_type &promise = handle.promise();
+            if (promise.owner_type == &impl::task_result_type_id<TTask>::value && UTIL_CONFIG_NULLPTR != promise.owner) {
+                owner_ = static_cast<TTask *>(promise.owner);
+                return owner_->_stackless_await(task_);
+            }
+
+            // stackless task of another type
+            if (UTIL_CONFIG_NULLPTR != promise.owner && UTIL_CONFIG_NULLPTR != promise.owner_hooks) {
+                return await_suspend_foreign(promise.owner, promise.owner_hooks);
+            }
+
+            return TTask::_push_coroutine_handle(task_, handle.address());
+        }
+
+        template <typename TPromise>
+        bool await_suspend(std::coroutine_handle<TPromise> handle) {
+            return TTask::_push_coroutine_handle(task_, handle.address());
+        }
+
+        int await_resume() {
+            if (!task_) {
+                return copp::COPP_EC_ARGS_ERROR;
+            }
+
+            if (UTIL_CONFIG_NULLPTR != owner_) {
+                return owner_->_stackless_await_resume();
+            }
+
+            if (UTIL_CONFIG_NULLPTR != foreign_hooks_) {
+                return (*foreign_hooks_->await_resume)(foreign_owner_);
+            }
+
+            return copp::COPP_EC_SUCCESS;
+        }
+
+    private:
+        bool await_suspend_foreign(impl::task_impl *owner, const impl::stackless_owner_hooks *hooks) {
+            foreign_owner_ = owner;
+            foreign_hooks_ = hooks;
+
+            uint32_t generation = 0;
+            if (!(*hooks->await_begin)(owner, &generation)) {
+                return false;
+            }
+
+            // the awaited task is already finished
+            if (!TTask::_push_stackless_owner(task_, owner, hooks, generation)) {
+                (*hooks->await_notify)(owner, generation, false);
+                return false;
+            }
+
+            // parked by start() after the coroutine is suspended
+            (*hooks->await_park)(owner);
+            return true;
+        }
+
+        ptr_t task_;
+        TTask *owner_;
+        impl::task_impl *foreign_owner_;
+        const impl::stackless_owner_hooks *foreign_hooks_;
+    };
+} // namespace cotask
+
+#endif
+
+#endif
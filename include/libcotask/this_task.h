@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <type_traits>
+
+#include <libcopp/utils/features.h>
 #include <libcotask/impl/task_impl.h>
 
 namespace cotask {
@@ -21,15 +24,58 @@ namespace cotask {
          * @brief get current running task
          * @return current running task or empty pointer when not in task
          */
-        impl::task_impl* get_task() UTIL_CONFIG_NOEXCEPT;
+        inline impl::task_impl* get_task() UTIL_CONFIG_NOEXCEPT {
+            return impl::task_impl::this_task();
+        }
+
+        namespace detail {
+            template <typename Tt, bool is_task>
+            struct task_cast {
+                static inline Tt *cast(impl::task_impl *t) UTIL_CONFIG_NOEXCEPT {
+                    if (t->get_type_id() == &impl::task_result_type_id<Tt>::value) {
+                        return static_cast<Tt *>(t);
+                    }
+
+#if defined(COPP_MACRO_ENABLE_RTTI) && COPP_MACRO_ENABLE_RTTI
+                    // maybe a base class of the task type
+                    return dynamic_cast<Tt *>(t);
+#else
+                    return UTIL_CONFIG_NULLPTR;
+#endif
+                }
+            };
+
+            template <typename Tt>
+            struct task_cast<Tt, false> {
+                static inline Tt *cast(impl::task_impl *t) UTIL_CONFIG_NOEXCEPT {
+#if defined(COPP_MACRO_ENABLE_RTTI) && COPP_MACRO_ENABLE_RTTI
+                    return dynamic_cast<Tt *>(t);
+#else
+                    return UTIL_CONFIG_NULLPTR;
+#endif
+                }
+            };
+
+            template <>
+            struct task_cast<impl::task_impl, true> {
+                static inline impl::task_impl *cast(impl::task_impl *t) UTIL_CONFIG_NOEXCEPT { return t; }
+            };
+        } // namespace detail
 
         /**
          * @brief get current running task and try to convert type
+         * @note the exact task type is checked by the type tag of the task without RTTI, other types use dynamic_cast
+         *       when RTTI is available
          * @return current running task or empty pointer when not in task or fail to convert type
          */
         template<typename Tt>
         Tt* get() {
-            return dynamic_cast<Tt*>(get_task());
+            impl::task_impl *ret = get_task();
+            if (UTIL_CONFIG_NULLPTR == ret) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            return detail::task_cast<Tt, std::is_base_of<impl::task_impl, Tt>::value>::cast(ret);
         }
     }
 }
@@ -69,7 +69,10 @@ if( ${CMAKE_CXX_COMPILER_ID} STREQUAL "GNU")
 
     if (CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "5.0.0")
         set(CMAKE_C_STANDARD 11)
-        if (CMAKE_VERSION VERSION_GREATER_EQUAL "3.8.0")
+        # C++20 coroutines, stackless tasks are available
+        if (LIBCOPP_ENABLE_CXX20 AND CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "10.0.0" AND CMAKE_VERSION VERSION_GREATER_EQUAL "3.12.0")
+            set(CMAKE_CXX_STANDARD 20)
+        elseif (CMAKE_VERSION VERSION_GREATER_EQUAL "3.8.0")
             set(CMAKE_CXX_STANDARD 17)
         else()
             set(CMAKE_CXX_STANDARD 14)
@@ -94,7 +97,10 @@ elseif( ${CMAKE_CXX_COMPILER_ID} STREQUAL "Clang")
     add_definitions(-Wall -Werror -fPIC)
     if (CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "3.4")
         set(CMAKE_C_STANDARD 11)
-        if (CMAKE_VERSION VERSION_GREATER_EQUAL "3.8.0")
+        # C++20 coroutines, stackless tasks are available
+        if (LIBCOPP_ENABLE_CXX20 AND CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "14.0" AND CMAKE_VERSION VERSION_GREATER_EQUAL "3.12.0")
+            set(CMAKE_CXX_STANDARD 20)
+        elseif (CMAKE_VERSION VERSION_GREATER_EQUAL "3.8.0")
             set(CMAKE_CXX_STANDARD 17)
         else()
             set(CMAKE_CXX_STANDARD 14)
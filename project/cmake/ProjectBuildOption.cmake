@@ -25,11 +25,25 @@ if (PROJECT_DISABLE_MT)
     set(LOCK_DISABLE_MT ON)
 endif()
 
+# Use initial-exec TLS model for current coroutine, so this_coroutine::get_coroutine() and
+# this_task::get_task() do not call __tls_get_addr. It's not suitable for libcopp built as a
+# shared library which is loaded by dlopen, so it's disabled by default for shared libraries.
+# COPP_MACRO_TLS_INITIAL_EXEC is written into the public build_feature.h, so every target which
+# includes libcopp headers also gets initial-exec TLS relocations for the inlined lookups. Turn
+# it OFF when the static library is linked into -fPIC modules which are loaded by dlopen, such
+# as plugins, or the loader may fail with "cannot allocate memory in static TLS block".
+if (BUILD_SHARED_LIBS)
+    option(LIBCOPP_ENABLE_TLS_INITIAL_EXEC "Use initial-exec TLS model for current coroutine(GCC/Clang on ELF only)." OFF)
+else()
+    option(LIBCOPP_ENABLE_TLS_INITIAL_EXEC "Use initial-exec TLS model for current coroutine(GCC/Clang on ELF only)." ON)
+endif()
+
 set(LIBCOPP_FCONTEXT_OS_PLATFORM "" CACHE STRING "set system platform. arm/arm64/i386/x86_64/combined/mips/ppc32/ppc64 and etc.")
 set(LIBCOPP_FCONTEXT_ABI "" CACHE STRING "set abi. sysv/aapcs/mips/o32/ms and etc.")
 set(LIBCOPP_FCONTEXT_BIN_FORMAT "" CACHE STRING "set binary format. elf/pe/macho/xcoff and etc.")
 set(LIBCOPP_FCONTEXT_AS_TOOL "" CACHE STRING "set as toolset. gas/armasm/masm and etc.")
 set(LIBCOPP_FCONTEXT_AS_ACTION "" CACHE STRING "set as action. x32/32/64 and etc.")
+set(LIBCOPP_FCONTEXT_BACKEND "fcontext" CACHE STRING "set context switch backend used by coroutine_context. fcontext/ucontext/minimal.")
 
 # [heading Intel Transactional Synchronisation Extensions (TSX)]
 # 
@@ -48,9 +62,35 @@ option(LIBCOPP_FCONTEXT_USE_TSX "Enable Intel Transactional Synchronisation Exte
 # tore/load of floating point related registers during a fiber (context) switch
 # are disabled.]
 
+# [heading Skip floating point control state in context switch]
+#
+# The x87 control word and MXCSR are callee-saved in the x86_64 System V ABI,
+# so each context switch saves and restores them. Programs which never change
+# the rounding mode or floating point exception masks can skip them to save
+# a few cycles per switch.
+option(LIBCOPP_FCONTEXT_NO_FPU_CONTROL "Do not save/restore x87 control word and MXCSR in context switch(x86_64 sysv only)." OFF)
+# [note Coroutines can not change rounding mode or floating point exception
+# masks when this is enabled, because the change leaks to the other side of
+# the switch.]
+
+# [heading Inline context switch]
+#
+# Use GCC/Clang inline asm to switch context in coroutine_context(x86_64 sysv
+# only). Callee-saved registers are declared as clobbered instead of being
+# saved by copp_jump_fcontext, so the compiler only spills what is live, and
+# there is no out-of-line call in the switch path.
+option(LIBCOPP_FCONTEXT_USE_INLINE_JUMP "Use inline asm to switch context in coroutine_context(x86_64 sysv only)." OFF)
+
+# number of coroutine-local slots in every coroutine_context, it changes the layout of coroutine_context
+set(LIBCOPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER 8 CACHE STRING "Number of coroutine-local slots in every coroutine.")
+
 # libcotask configure
 option(LIBCOTASK_ENABLE "Enable libcotask." ON)
 
+# Build with C++20 on GCC >= 10 and Clang >= 14, so C++20 coroutines and stackless tasks are available.
+# It changes the language standard of the whole build, C++17 is used when it's OFF.
+option(LIBCOPP_ENABLE_CXX20 "Build with C++20 to enable stackless tasks(GCC >= 10 or Clang >= 14)." OFF)
+
 # unit test framework
 set(GTEST_ROOT "" CACHE STRING "GTest root directory")
 set(BOOST_ROOT "" CACHE STRING "Boost root directory")
@@ -0,0 +1,112 @@
+/*
+ * sample_benchmark_coroutine_reset.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+#include <vector>
+
+// include manager header file
+#include <libcopp/coroutine/coroutine_context_container.h>
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::steady_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::steady_clock::now()
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+int switch_count = 1;
+
+// a short job
+static int my_runner(void *priv_data) {
+    int count = switch_count;
+    while (count-- > 0) {
+        copp::this_coroutine::yield();
+    }
+
+    ++(*reinterpret_cast<long long *>(priv_data));
+    return 0;
+}
+
+static void run_job(copp::coroutine_context_default &co, long long &done) {
+    co.start(&done);
+    while (!co.is_finished()) {
+        co.resume(&done);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    puts("###################### coroutine create per job vs reset per job (fiber pool) ###################");
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    int max_job_number = 100000;
+    if (argc > 1) {
+        max_job_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        switch_count = atoi(argv[2]);
+    }
+
+    size_t stack_size = 16 * 1024;
+    if (argc > 3) {
+        stack_size = atoi(argv[3]) * 1024;
+    }
+
+    // create and destroy a coroutine for every job
+    long long    done        = 0;
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+    for (int i = 0; i < max_job_number; ++i) {
+        copp::coroutine_context_default::ptr_t co = copp::coroutine_context_default::create(my_runner, stack_size);
+        if (!co) {
+            fprintf(stderr, "coroutine create failed\n");
+            return 1;
+        }
+        run_job(*co, done);
+    }
+    CALC_CLOCK_T end_clock = CALC_CLOCK_NOW();
+    printf("create per job: %lld jobs, avg: %lld ns\n", done, CALC_NS_AVG_CLOCK(end_clock - begin_clock, done));
+
+    // a small pool of coroutines reset for every job, nothing is allocated per job
+    const int                                           pool_size = 64;
+    std::vector<copp::coroutine_context_default::ptr_t> pool;
+    for (int i = 0; i < pool_size; ++i) {
+        pool.push_back(copp::coroutine_context_default::create(my_runner, stack_size));
+        if (!pool.back()) {
+            fprintf(stderr, "coroutine create failed\n");
+            return 1;
+        }
+        run_job(*pool.back(), done);
+    }
+
+    done        = 0;
+    begin_clock = CALC_CLOCK_NOW();
+    for (int i = 0; i < max_job_number; ++i) {
+        copp::coroutine_context_default &co = *pool[i % pool_size];
+        co.restart();
+        run_job(co, done);
+    }
+    end_clock = CALC_CLOCK_NOW();
+    printf("reset per job: %lld jobs, avg: %lld ns\n", done, CALC_NS_AVG_CLOCK(end_clock - begin_clock, done));
+
+    return 0;
+}
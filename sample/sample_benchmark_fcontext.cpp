@@ -0,0 +1,160 @@
+/*
+ * sample_benchmark_fcontext.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+
+// include fcontext header file
+#include <libcopp/fcontext/all.hpp>
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::system_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::system_clock::now()
+#define CALC_MS_CLOCK(x) static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(x).count())
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_MS_CLOCK(x) static_cast<int>((x) / (CLOCKS_PER_SEC / 1000))
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+int switch_count = 100;
+
+// raw context entry, jump back to caller switch_count times
+static void my_context_func(copp::fcontext::transfer_t src) {
+    int count = switch_count;
+    while (count-- > 0) {
+        src = copp::fcontext::copp_jump_fcontext(src.fctx, src.data);
+    }
+
+    // mark finished and never come back
+    *reinterpret_cast<bool *>(src.data) = true;
+    copp::fcontext::copp_jump_fcontext(src.fctx, src.data);
+}
+
+#if defined(COPP_FCONTEXT_HAS_INLINE_JUMP) && COPP_FCONTEXT_HAS_INLINE_JUMP
+// the same as my_context_func, but use inline asm to switch context
+static void my_context_func_inline(copp::fcontext::transfer_t src) {
+    int count = switch_count;
+    while (count-- > 0) {
+        src = copp::fcontext::copp_jump_fcontext_inline(src.fctx, src.data);
+    }
+
+    *reinterpret_cast<bool *>(src.data) = true;
+    copp::fcontext::copp_jump_fcontext_inline(src.fctx, src.data);
+}
+#endif
+
+int                         max_coroutine_number = 100000; // 协程数量
+copp::fcontext::fcontext_t *ctx_arr              = NULL;
+bool *                      finished_arr         = NULL;
+unsigned char *             stack_buffer         = NULL;
+
+static void run_benchmark(const char *name, void (*fn)(copp::fcontext::transfer_t), bool use_inline, size_t stack_size) {
+    time_t       begin_time  = time(NULL);
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+
+    for (int i = 0; i < max_coroutine_number; ++i) {
+        finished_arr[i] = false;
+        ctx_arr[i]      = copp::fcontext::copp_make_fcontext(stack_buffer + stack_size * (i + 1), stack_size, fn);
+    }
+
+    time_t       end_time  = time(NULL);
+    CALC_CLOCK_T end_clock = CALC_CLOCK_NOW();
+    printf("[%s] create %d fcontext, cost time: %d s, clock time: %d ms, avg: %lld ns\n", name, max_coroutine_number,
+           static_cast<int>(end_time - begin_time), CALC_MS_CLOCK(end_clock - begin_clock),
+           CALC_NS_AVG_CLOCK(end_clock - begin_clock, max_coroutine_number));
+
+    begin_time  = end_time;
+    begin_clock = end_clock;
+
+    // jump into and back from contexts, each resume has 2 switches
+    bool      continue_flag     = true;
+    long long real_switch_times = static_cast<long long>(0);
+
+    while (continue_flag) {
+        continue_flag = false;
+        for (int i = 0; i < max_coroutine_number; ++i) {
+            if (false == finished_arr[i]) {
+                continue_flag = true;
+                real_switch_times += 2;
+                copp::fcontext::transfer_t res;
+#if defined(COPP_FCONTEXT_HAS_INLINE_JUMP) && COPP_FCONTEXT_HAS_INLINE_JUMP
+                if (use_inline) {
+                    res = copp::fcontext::copp_jump_fcontext_inline(ctx_arr[i], &finished_arr[i]);
+                } else {
+                    res = copp::fcontext::copp_jump_fcontext(ctx_arr[i], &finished_arr[i]);
+                }
+#else
+                (void)use_inline;
+                res = copp::fcontext::copp_jump_fcontext(ctx_arr[i], &finished_arr[i]);
+#endif
+                ctx_arr[i] = res.fctx;
+            }
+        }
+    }
+
+    end_time  = time(NULL);
+    end_clock = CALC_CLOCK_NOW();
+    printf("[%s] switch %d fcontext %lld times, cost time: %d s, clock time: %d ms, avg: %lld ns\n", name, max_coroutine_number,
+           real_switch_times, static_cast<int>(end_time - begin_time), CALC_MS_CLOCK(end_clock - begin_clock),
+           CALC_NS_AVG_CLOCK(end_clock - begin_clock, real_switch_times));
+}
+
+int main(int argc, char *argv[]) {
+#if defined(COPP_FCONTEXT_NO_FPU_CONTROL) || defined(COPP_FCONTEXT_USE_TSX)
+    puts("###################### fcontext (without x87 control word and MXCSR) ###################");
+#else
+    puts("###################### fcontext (with x87 control word and MXCSR) ###################");
+#endif
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    if (argc > 1) {
+        max_coroutine_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        switch_count = atoi(argv[2]);
+    }
+
+    size_t stack_size = 16 * 1024;
+    if (argc > 3) {
+        stack_size = atoi(argv[3]) * 1024;
+    }
+
+    ctx_arr      = new copp::fcontext::fcontext_t[max_coroutine_number];
+    finished_arr = new bool[max_coroutine_number];
+    stack_buffer = reinterpret_cast<unsigned char *>(malloc(stack_size * max_coroutine_number));
+    if (NULL == stack_buffer) {
+        fprintf(stderr, "allocate stack buffer failed\n");
+        return 1;
+    }
+
+    run_benchmark("copp_jump_fcontext", my_context_func, false, stack_size);
+#if defined(COPP_FCONTEXT_HAS_INLINE_JUMP) && COPP_FCONTEXT_HAS_INLINE_JUMP
+    run_benchmark("copp_jump_fcontext_inline", my_context_func_inline, true, stack_size);
+#endif
+
+    free(stack_buffer);
+    delete[] finished_arr;
+    delete[] ctx_arr;
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * sample_benchmark_fcontext_backend.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+
+// include fcontext header file
+#include <libcopp/fcontext/all.hpp>
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::system_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::system_clock::now()
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+int                         switch_count         = 100;
+int                         max_coroutine_number = 10000; // 协程数量
+copp::fcontext::fcontext_t *ctx_arr              = NULL;
+bool *                      finished_arr         = NULL;
+unsigned char *             stack_buffer         = NULL;
+
+template <typename TBackend>
+struct benchmark_runner {
+    // jump back to caller switch_count times
+    static void context_func(copp::fcontext::transfer_t src) {
+        int count = switch_count;
+        while (count-- > 0) {
+            src = TBackend::jump(src.fctx, src.data);
+        }
+
+        // mark finished and never come back
+        *reinterpret_cast<bool *>(src.data) = true;
+        TBackend::jump(src.fctx, src.data);
+    }
+
+    static void run(size_t stack_size) {
+        CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+        for (int i = 0; i < max_coroutine_number; ++i) {
+            finished_arr[i] = false;
+            ctx_arr[i]      = TBackend::make(stack_buffer + stack_size * (i + 1), stack_size, context_func);
+        }
+        CALC_CLOCK_T end_clock   = CALC_CLOCK_NOW();
+        long long    create_avg  = CALC_NS_AVG_CLOCK(end_clock - begin_clock, max_coroutine_number);
+
+        // jump into and back from contexts, each resume has 2 switches
+        bool      continue_flag     = true;
+        long long real_switch_times = static_cast<long long>(0);
+
+        begin_clock = end_clock;
+        while (continue_flag) {
+            continue_flag = false;
+            for (int i = 0; i < max_coroutine_number; ++i) {
+                if (false == finished_arr[i]) {
+                    continue_flag = true;
+                    real_switch_times += 2;
+                    ctx_arr[i] = TBackend::jump(ctx_arr[i], &finished_arr[i]).fctx;
+                }
+            }
+        }
+        end_clock = CALC_CLOCK_NOW();
+
+        printf("| %-10s | %14lld | %14lld |\n", TBackend::name(), create_avg, CALC_NS_AVG_CLOCK(end_clock - begin_clock, real_switch_times));
+    }
+};
+
+int main(int argc, char *argv[]) {
+    puts("###################### fcontext backends ###################");
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    if (argc > 1) {
+        max_coroutine_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        switch_count = atoi(argv[2]);
+    }
+
+    size_t stack_size = 16 * 1024;
+    if (argc > 3) {
+        stack_size = atoi(argv[3]) * 1024;
+    }
+
+    ctx_arr      = new copp::fcontext::fcontext_t[max_coroutine_number];
+    finished_arr = new bool[max_coroutine_number];
+    stack_buffer = reinterpret_cast<unsigned char *>(malloc(stack_size * max_coroutine_number));
+    if (NULL == stack_buffer) {
+        fprintf(stderr, "allocate stack buffer failed\n");
+        return 1;
+    }
+    // touch all stack pages, so page faults are not counted in the first backend
+    // fill with non-zero, or compiler may merge malloc and memset into calloc, which does not touch fresh pages
+    memset(stack_buffer, 0xcc, stack_size * max_coroutine_number);
+
+    printf("coroutine_context backend: %s\n", copp::fcontext::backend_t::name());
+    puts("| backend    | create (ns/op) | switch (ns/op) |");
+    puts("|------------|----------------|----------------|");
+    benchmark_runner<copp::fcontext::backend_fcontext>::run(stack_size);
+#if defined(COPP_FCONTEXT_HAS_MINIMAL_BACKEND) && COPP_FCONTEXT_HAS_MINIMAL_BACKEND
+    benchmark_runner<copp::fcontext::backend_minimal>::run(stack_size);
+#endif
+#if defined(COPP_FCONTEXT_HAS_UCONTEXT_BACKEND) && COPP_FCONTEXT_HAS_UCONTEXT_BACKEND
+    benchmark_runner<copp::fcontext::backend_ucontext>::run(stack_size);
+#endif
+
+    free(stack_buffer);
+    delete[] finished_arr;
+    delete[] ctx_arr;
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * sample_benchmark_pipeline.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+
+// include pipeline header file
+#include <libcopp/coroutine/pipeline.h>
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::steady_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::steady_clock::now()
+#define CALC_NS_CLOCK(x) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count())
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_NS_CLOCK(x) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)))
+#endif
+
+typedef copp::pipeline_channel<uint64_t> channel_t;
+
+long long  max_item_number = 10000000;
+channel_t *source_to_map   = NULL;
+channel_t *map_to_sink     = NULL;
+uint64_t   sink_result     = 0;
+
+// stage 1: generate items
+static int stage_source(void *) {
+    for (long long i = 0; i < max_item_number; ++i) {
+        source_to_map->push(static_cast<uint64_t>(i));
+    }
+    source_to_map->close();
+    return 0;
+}
+
+// stage 2: transform items
+static int stage_map(void *) {
+    uint64_t v;
+    while (0 == source_to_map->pop(v)) {
+        map_to_sink->push(v * 2 + 1);
+    }
+    map_to_sink->close();
+    return 0;
+}
+
+// stage 3: reduce items
+static int stage_sink(void *) {
+    uint64_t v;
+    uint64_t sum = 0;
+    while (0 == map_to_sink->pop(v)) {
+        sum += v;
+    }
+    sink_result = sum;
+    return 0;
+}
+
+static void run_benchmark(size_t batch_size, size_t stack_size) {
+    channel_t ch1(batch_size);
+    channel_t ch2(batch_size);
+    source_to_map = &ch1;
+    map_to_sink   = &ch2;
+
+    copp::pipeline<> pl;
+    pl.add_stage(stage_source, stack_size);
+    pl.add_stage(stage_map, stack_size);
+    pl.add_stage(stage_sink, stack_size);
+
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+    pl.run();
+    CALC_CLOCK_T end_clock = CALC_CLOCK_NOW();
+
+    long long ns = CALC_NS_CLOCK(end_clock - begin_clock);
+    if (ns <= 0) {
+        ns = 1;
+    }
+    printf("| %10d | %12.2f | %10.2f |\n", static_cast<int>(ch1.capacity()), static_cast<double>(max_item_number) * 1000.0 / ns,
+           static_cast<double>(ns) / static_cast<double>(max_item_number ? max_item_number : 1));
+
+    uint64_t n = static_cast<uint64_t>(max_item_number);
+    if (sink_result != n * n) {
+        fprintf(stderr, "unexpected result %llu\n", static_cast<unsigned long long>(sink_result));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    puts("###################### 3-stage pipeline (source -> map -> sink) ###################");
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    // item number = [stream number] * [items per stream], to keep the same arguments as other benchmarks
+    if (argc > 2) {
+        max_item_number = atoll(argv[1]) * atoll(argv[2]);
+    } else if (argc > 1) {
+        max_item_number = atoll(argv[1]);
+    }
+
+    size_t stack_size = 16 * 1024;
+    if (argc > 3) {
+        stack_size = atoi(argv[3]) * 1024;
+    }
+
+    puts("| batch size | M items/sec  | ns/item    |");
+    puts("|------------|--------------|------------|");
+    size_t batch_sizes[] = {1, 4, 16, 64, 256, 1024, 4096};
+    for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); ++i) {
+        run_benchmark(batch_sizes[i], stack_size);
+    }
+
+    return 0;
+}
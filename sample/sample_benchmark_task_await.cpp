@@ -0,0 +1,217 @@
+/*
+ * sample_benchmark_task_await.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+#include <vector>
+
+// include manager header file
+#include <libcotask/task.h>
+
+#ifdef COTASK_MACRO_ENABLED
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::system_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::system_clock::now()
+#define CALC_MS_CLOCK(x) static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(x).count())
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_MS_CLOCK(x) static_cast<int>((x) / (CLOCKS_PER_SEC / 1000))
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+typedef cotask::task<> my_task_t;
+
+int    switch_count    = 100;
+int    max_task_number = 1000; // 协程Task数量
+size_t stack_size      = 16 * 1024;
+
+std::vector<my_task_t::ptr_t> task_arr;
+std::vector<my_task_t::ptr_t> sub_task_arr;
+long long                     wake_times = 0;
+
+// the awaited task, which is running for a while
+int my_target_action(void *) {
+    int count = switch_count;
+
+    while (count-- > 0) {
+        cotask::this_task::get_task()->yield();
+    }
+
+    return 0;
+}
+
+// await the task passed by start()
+int my_await_action(void *priv_data) {
+    my_task_t *wait_task = reinterpret_cast<my_task_t *>(priv_data);
+    my_task_t::this_task()->await(wait_task);
+    return 0;
+}
+
+// await all the sub tasks one by one
+int my_await_each_action(void *) {
+    for (size_t i = 0; i < sub_task_arr.size(); ++i) {
+        my_task_t::this_task()->await(sub_task_arr[i]);
+        ++wake_times;
+    }
+    return 0;
+}
+
+// await all the sub tasks at once
+int my_when_all_action(void *) {
+    my_task_t::this_task()->when_all(sub_task_arr);
+    ++wake_times;
+    return 0;
+}
+
+// resume all unfinished tasks like a scheduler without any knowledge of await
+static void run_all_tasks(const char *name, CALC_CLOCK_T begin_clock) {
+    bool      continue_flag     = true;
+    long long real_resume_times = static_cast<long long>(0);
+    long long real_switch_times = static_cast<long long>(0);
+
+    while (continue_flag) {
+        continue_flag = false;
+        for (size_t i = 0; i < task_arr.size(); ++i) {
+            if (false == task_arr[i]->is_completed()) {
+                continue_flag = true;
+                ++real_resume_times;
+                if (0 == task_arr[i]->resume()) {
+                    ++real_switch_times;
+                }
+            }
+        }
+    }
+
+    CALC_CLOCK_T end_clock = CALC_CLOCK_NOW();
+    printf("%s: %d tasks, resume %lld times, switch %lld times, clock time: %d ms, avg: %lld ns per task\n", name, max_task_number,
+           real_resume_times, real_switch_times, CALC_MS_CLOCK(end_clock - begin_clock),
+           CALC_NS_AVG_CLOCK(end_clock - begin_clock, max_task_number));
+}
+
+static bool create_tasks() {
+    task_arr.reserve(static_cast<size_t>(max_task_number) + 1);
+    task_arr.push_back(my_task_t::create(my_target_action, stack_size));
+    while (task_arr.size() <= static_cast<size_t>(max_task_number)) {
+        task_arr.push_back(my_task_t::create(my_await_action, stack_size));
+    }
+
+    for (size_t i = 0; i < task_arr.size(); ++i) {
+        if (!task_arr[i]) {
+            fprintf(stderr, "create coroutine task failed, real size is %d.\n", static_cast<int>(i));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// task[i] awaits task[i - 1], and task[0] is the target
+static void benchmark_chain() {
+    if (!create_tasks()) {
+        return;
+    }
+
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+    task_arr[0]->start();
+    for (size_t i = 1; i < task_arr.size(); ++i) {
+        task_arr[i]->start(task_arr[i - 1].get());
+    }
+
+    run_all_tasks("await chain", begin_clock);
+    task_arr.clear();
+}
+
+// all tasks await task[0]
+static void benchmark_fan_in() {
+    if (!create_tasks()) {
+        return;
+    }
+
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+    task_arr[0]->start();
+    for (size_t i = 1; i < task_arr.size(); ++i) {
+        task_arr[i]->start(task_arr[0].get());
+    }
+
+    run_all_tasks("await fan-in", begin_clock);
+    task_arr.clear();
+}
+
+// one task awaits all the other tasks, like fan-out/fan-in RPC
+static void benchmark_fan_out(const char *name, int (*action)(void *)) {
+    if (!create_tasks()) {
+        return;
+    }
+
+    task_arr[0] = my_task_t::create(action, stack_size);
+    sub_task_arr.assign(task_arr.begin() + 1, task_arr.end());
+    for (size_t i = 0; i < sub_task_arr.size(); ++i) {
+        sub_task_arr[i] = my_task_t::create(my_target_action, stack_size);
+    }
+
+    for (size_t i = 0; i < sub_task_arr.size(); ++i) {
+        task_arr[i + 1] = sub_task_arr[i];
+        task_arr[i + 1]->start();
+    }
+
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+    wake_times               = 0;
+    task_arr[0]->start();
+
+    run_all_tasks(name, begin_clock);
+    printf("%s: awaiting task is woken %lld times\n", name, wake_times);
+    task_arr.clear();
+    sub_task_arr.clear();
+}
+
+int main(int argc, char *argv[]) {
+    puts("###################### task await chain and fan-in ###################");
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    if (argc > 1) {
+        max_task_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        switch_count = atoi(argv[2]);
+    }
+
+    if (argc > 3) {
+        stack_size = static_cast<size_t>(atoi(argv[3]) * 1024);
+    }
+
+    for (int i = 1; i <= 5; ++i) {
+        printf("### Round: %d ###\n", i);
+        benchmark_chain();
+        benchmark_fan_in();
+        benchmark_fan_out("await each", my_await_each_action);
+        benchmark_fan_out("when_all", my_when_all_action);
+    }
+    return 0;
+}
+#else
+int main() {
+    puts("cotask disabled.");
+    return 0;
+}
+
+#endif
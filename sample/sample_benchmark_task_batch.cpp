@@ -0,0 +1,151 @@
+/*
+ * sample_benchmark_task_batch.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+#include <vector>
+
+// include manager header file
+#include <libcopp/stack/stack_pool.h>
+#include <libcotask/task.h>
+
+#ifdef COTASK_MACRO_ENABLED
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::system_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::system_clock::now()
+#define CALC_MS_CLOCK(x) static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(x).count())
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_MS_CLOCK(x) static_cast<int>((x) / (CLOCKS_PER_SEC / 1000))
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+typedef copp::stack_pool<copp::allocator::default_statck_allocator> stack_pool_t;
+stack_pool_t::ptr_t                                                 global_stack_pool;
+
+struct my_macro_coroutine {
+    typedef copp::allocator::stack_allocator_pool<stack_pool_t> stack_allocator_t;
+
+    typedef copp::coroutine_context_container<stack_allocator_t> coroutine_t;
+};
+
+typedef cotask::task<my_macro_coroutine> my_task_t;
+
+int    switch_count    = 100;
+int    max_task_number = 100000; // 协程Task数量
+size_t stack_size      = 16 * 1024;
+
+std::vector<my_task_t::ptr_t> task_arr;
+
+struct my_task_action {
+    int operator()(void *) {
+        int count = switch_count;
+
+        while (count-- > 0) {
+            cotask::this_task::get_task()->yield();
+        }
+
+        return 0;
+    }
+};
+
+static my_task_action my_task_factory(size_t) { return my_task_action(); }
+
+static void benchmark_create(bool use_batch) {
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+
+    if (use_batch) {
+        copp::allocator::stack_allocator_pool<stack_pool_t> alloc(global_stack_pool);
+        task_arr = my_task_t::create_batch(static_cast<size_t>(max_task_number), my_task_factory, alloc, stack_size);
+    } else {
+        task_arr.reserve(static_cast<size_t>(max_task_number));
+        while (task_arr.size() < static_cast<size_t>(max_task_number)) {
+            copp::allocator::stack_allocator_pool<stack_pool_t> alloc(global_stack_pool);
+            my_task_t::ptr_t                                    new_task = my_task_t::create(my_task_action(), alloc, stack_size);
+            if (!new_task) {
+                break;
+            }
+            task_arr.push_back(new_task);
+        }
+    }
+
+    CALC_CLOCK_T end_clock = CALC_CLOCK_NOW();
+    if (task_arr.size() < static_cast<size_t>(max_task_number)) {
+        fprintf(stderr, "create coroutine task failed, real size is %d.\n", static_cast<int>(task_arr.size()));
+        fprintf(stderr, "maybe sysconf [vm.max_map_count] extended.\n");
+    }
+    printf("create %d tasks by %-6s, clock time: %d ms, avg: %lld ns\n", static_cast<int>(task_arr.size()), use_batch ? "batch" : "create",
+           CALC_MS_CLOCK(end_clock - begin_clock), CALC_NS_AVG_CLOCK(end_clock - begin_clock, task_arr.size()));
+
+    // run them to release the stacks
+    for (size_t i = 0; i < task_arr.size(); ++i) {
+        task_arr[i]->start();
+    }
+
+    bool continue_flag = true;
+    while (continue_flag) {
+        continue_flag = false;
+        for (size_t i = 0; i < task_arr.size(); ++i) {
+            if (false == task_arr[i]->is_completed()) {
+                continue_flag = true;
+                task_arr[i]->resume();
+            }
+        }
+    }
+
+    task_arr.clear();
+}
+
+int main(int argc, char *argv[]) {
+    puts("###################### task create in batch (stack using stack pool) ###################");
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    if (argc > 1) {
+        max_task_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        switch_count = atoi(argv[2]);
+    }
+
+    if (argc > 3) {
+        stack_size = static_cast<size_t>(atoi(argv[3]) * 1024);
+    }
+
+    global_stack_pool = stack_pool_t::create();
+    global_stack_pool->set_min_stack_number(static_cast<size_t>(max_task_number));
+    global_stack_pool->set_stack_size(stack_size);
+
+    for (int i = 1; i <= 5; ++i) {
+        printf("### Round: %d ###\n", i);
+        benchmark_create(false);
+        benchmark_create(true);
+    }
+    return 0;
+}
+#else
+int main() {
+    puts("cotask disabled.");
+    return 0;
+}
+
+#endif
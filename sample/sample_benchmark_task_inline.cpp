@@ -0,0 +1,144 @@
+/*
+ * sample_benchmark_task_inline.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+#include <vector>
+
+// include manager header file
+#include <libcotask/task.h>
+
+#ifdef COTASK_MACRO_ENABLED
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::system_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::system_clock::now()
+#define CALC_MS_CLOCK(x) static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(x).count())
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_MS_CLOCK(x) static_cast<int>((x) / (CLOCKS_PER_SEC / 1000))
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+typedef cotask::task<> my_task_t;
+
+int    switch_count    = 100;
+int    max_task_number = 100000; // 协程Task数量
+size_t stack_size      = 16 * 1024;
+
+std::vector<my_task_t::ptr_t> task_arr;
+
+// cache hit, finished without yield
+int my_hit_action(void *) { return 0; }
+
+// cache miss, wait for something
+int my_miss_action(void *) {
+    int count = switch_count;
+
+    while (count-- > 0) {
+        cotask::this_task::get_task()->yield();
+    }
+
+    return 0;
+}
+
+// hit_percent of the tasks are cache hits, and they're created by create_inline() if use_inline is true
+static void benchmark_mixed(int hit_percent, bool use_inline) {
+    task_arr.reserve(static_cast<size_t>(max_task_number));
+
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+
+    // create and start all the tasks, the cache hits finish here
+    for (int i = 0; i < max_task_number; ++i) {
+        bool            hit = (i % 100) < hit_percent;
+        my_task_t::ptr_t task;
+        if (!hit) {
+            task = my_task_t::create(my_miss_action, stack_size);
+        } else if (use_inline) {
+            task = my_task_t::create_inline(my_hit_action);
+        } else {
+            task = my_task_t::create(my_hit_action, stack_size);
+        }
+
+        if (!task) {
+            fprintf(stderr, "create coroutine task failed, real size is %d.\n", i);
+            task_arr.clear();
+            return;
+        }
+
+        task->start();
+        if (!task->is_completed()) {
+            task_arr.push_back(task);
+        }
+    }
+
+    // resume the cache misses
+    bool continue_flag = true;
+    while (continue_flag) {
+        continue_flag = false;
+        for (size_t i = 0; i < task_arr.size(); ++i) {
+            if (false == task_arr[i]->is_completed()) {
+                continue_flag = true;
+                task_arr[i]->resume();
+            }
+        }
+    }
+
+    task_arr.clear();
+
+    CALC_CLOCK_T end_clock = CALC_CLOCK_NOW();
+    printf("%3d%% hits, %-9s: %d tasks, clock time: %d ms, avg: %lld ns per task\n", hit_percent, use_inline ? "inline" : "stackful",
+           max_task_number, CALC_MS_CLOCK(end_clock - begin_clock), CALC_NS_AVG_CLOCK(end_clock - begin_clock, max_task_number));
+}
+
+int main(int argc, char *argv[]) {
+    puts("###################### task inline with mixed workloads ###################");
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    if (argc > 1) {
+        max_task_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        switch_count = atoi(argv[2]);
+    }
+
+    if (argc > 3) {
+        stack_size = static_cast<size_t>(atoi(argv[3]) * 1024);
+    }
+
+    const int hit_percents[] = {100, 90, 50};
+    for (int i = 1; i <= 5; ++i) {
+        printf("### Round: %d ###\n", i);
+        for (size_t j = 0; j < sizeof(hit_percents) / sizeof(hit_percents[0]); ++j) {
+            benchmark_mixed(hit_percents[j], false);
+            benchmark_mixed(hit_percents[j], true);
+        }
+    }
+    return 0;
+}
+#else
+int main() {
+    puts("cotask disabled.");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * sample_benchmark_this_task.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <inttypes.h>
+#include <stdint.h>
+#include <vector>
+
+// include manager header file
+#include <libcotask/task.h>
+
+#ifdef COTASK_MACRO_ENABLED
+
+#if defined(PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO) && PROJECT_LIBCOPP_SAMPLE_HAS_CHRONO
+#include <chrono>
+#define CALC_CLOCK_T std::chrono::system_clock::time_point
+#define CALC_CLOCK_NOW() std::chrono::system_clock::now()
+#define CALC_MS_CLOCK(x) static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(x).count())
+#define CALC_NS_AVG_CLOCK(x, y) static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(x).count() / (y ? y : 1))
+#else
+#define CALC_CLOCK_T clock_t
+#define CALC_CLOCK_NOW() clock()
+#define CALC_MS_CLOCK(x) static_cast<int>((x) / (CLOCKS_PER_SEC / 1000))
+#define CALC_NS_AVG_CLOCK(x, y) (1000000LL * static_cast<long long>((x) / (CLOCKS_PER_SEC / 1000)) / (y ? y : 1))
+#endif
+
+typedef cotask::task<> my_task_t;
+
+int                           lookup_count    = 100;
+int                           max_task_number = 1000; // 协程Task数量
+std::vector<my_task_t::ptr_t> task_arr;
+
+// keep the compiler from eliminating the lookups
+volatile uintptr_t lookup_sink = 0;
+
+// call this_coroutine::get_coroutine() lookup_count times
+static int my_coroutine_lookup_action(void *) {
+    for (int i = 0; i < lookup_count; ++i) {
+        lookup_sink = reinterpret_cast<uintptr_t>(copp::this_coroutine::get_coroutine());
+    }
+
+    return 0;
+}
+
+// call this_task::get_task() lookup_count times
+static int my_task_lookup_action(void *) {
+    for (int i = 0; i < lookup_count; ++i) {
+        lookup_sink = reinterpret_cast<uintptr_t>(cotask::this_task::get_task());
+    }
+
+    return 0;
+}
+
+static void run_benchmark(const char *name, int (*fn)(void *), size_t stack_size) {
+    task_arr.clear();
+    task_arr.reserve(static_cast<size_t>(max_task_number));
+    while (task_arr.size() < static_cast<size_t>(max_task_number)) {
+        my_task_t::ptr_t new_task = my_task_t::create(fn, stack_size);
+        if (!new_task) {
+            fprintf(stderr, "create coroutine task failed, real size is %d.\n", static_cast<int>(task_arr.size()));
+            fprintf(stderr, "maybe sysconf [vm.max_map_count] extended.\n");
+            max_task_number = static_cast<int>(task_arr.size());
+            break;
+        }
+        task_arr.push_back(new_task);
+    }
+
+    time_t       begin_time  = time(NULL);
+    CALC_CLOCK_T begin_clock = CALC_CLOCK_NOW();
+
+    for (int i = 0; i < max_task_number; ++i) {
+        task_arr[i]->start();
+    }
+
+    time_t       end_time     = time(NULL);
+    CALC_CLOCK_T end_clock    = CALC_CLOCK_NOW();
+    long long    lookup_times = static_cast<long long>(max_task_number) * lookup_count;
+    printf("[%s] lookup in %d tasks %lld times, cost time: %d s, clock time: %d ms, avg: %lld ns\n", name, max_task_number, lookup_times,
+           static_cast<int>(end_time - begin_time), CALC_MS_CLOCK(end_clock - begin_clock),
+           CALC_NS_AVG_CLOCK(end_clock - begin_clock, lookup_times));
+
+    task_arr.clear();
+}
+
+int main(int argc, char *argv[]) {
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+    puts("###################### this_task (initial-exec TLS) ###################");
+#else
+    puts("###################### this_task ###################");
+#endif
+    printf("########## Cmd:");
+    for (int i = 0; i < argc; ++i) {
+        printf(" %s", argv[i]);
+    }
+    puts("");
+
+    if (argc > 1) {
+        max_task_number = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        lookup_count = atoi(argv[2]);
+    }
+
+    size_t stack_size = 16 * 1024;
+    if (argc > 3) {
+        stack_size = atoi(argv[3]) * 1024;
+    }
+
+    run_benchmark("this_coroutine::get_coroutine", my_coroutine_lookup_action, stack_size);
+    run_benchmark("this_task::get_task", my_task_lookup_action, stack_size);
+
+    return 0;
+}
+#else
+int main() {
+    puts("cotask disabled");
+    return 0;
+}
+#endif
@@ -6,6 +6,8 @@
 #include <libcopp/utils/errno.h>
 
 #include <libcopp/coroutine/coroutine_context.h>
+#include <libcopp/fcontext/backend.hpp>
+#include <libcopp/fcontext/jump_inline.hpp>
 
 #ifndef UTIL_CONFIG_THREAD_LOCAL
 
@@ -28,7 +30,11 @@ void __splitstack_block_signals_context(void * [COPP_MACRO_SEGMENTED_STACK_NUMBE
 namespace copp {
     namespace detail {
 
-#ifndef UTIL_CONFIG_THREAD_LOCAL
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+
+        COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC coroutine_context *gt_current_coroutine = UTIL_CONFIG_NULLPTR;
+
+#elif !defined(UTIL_CONFIG_THREAD_LOCAL)
 
         static pthread_once_t gt_coroutine_init_once = PTHREAD_ONCE_INIT;
         static pthread_key_t gt_coroutine_tls_key;
@@ -40,8 +46,10 @@ namespace copp {
 
 #endif
 
-        static void set_this_coroutine_context(coroutine_context *p) {
-#ifndef UTIL_CONFIG_THREAD_LOCAL
+        static inline void set_this_coroutine_context(coroutine_context *p) {
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+            gt_current_coroutine = p;
+#elif !defined(UTIL_CONFIG_THREAD_LOCAL)
             (void)pthread_once(&gt_coroutine_init_once, init_pthread_this_coroutine_context);
             pthread_setspecific(gt_coroutine_tls_key, p);
 #else
@@ -49,8 +57,10 @@ namespace copp {
 #endif
         }
 
-        static coroutine_context *get_this_coroutine_context() {
-#ifndef UTIL_CONFIG_THREAD_LOCAL
+        static inline coroutine_context *get_this_coroutine_context() {
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+            return gt_current_coroutine;
+#elif !defined(UTIL_CONFIG_THREAD_LOCAL)
             (void)pthread_once(&gt_coroutine_init_once, init_pthread_this_coroutine_context);
             return reinterpret_cast<coroutine_context *>(pthread_getspecific(gt_coroutine_tls_key));
 #else
@@ -58,13 +68,37 @@ namespace copp {
             return gt_current_coroutine;
 #endif
         }
-    }
+
+        struct coroutine_local_registry_t {
+            util::lock::atomic_int_type<size_t> slot_count;
+            void (*destructors[COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER])(void *);
+        };
+
+        // function local static, so keys can be registered in static initializers of other units
+        static coroutine_local_registry_t &get_coroutine_local_registry() {
+            static coroutine_local_registry_t ret;
+            return ret;
+        }
+
+        int coroutine_local_alloc_slot(void (*destructor)(void *)) UTIL_CONFIG_NOEXCEPT {
+            coroutine_local_registry_t &registry = get_coroutine_local_registry();
+            size_t index = registry.slot_count.fetch_add(1);
+            if (index >= COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER) {
+                registry.slot_count.fetch_sub(1);
+                return COPP_EC_OUT_OF_RANGE;
+            }
+
+            registry.destructors[index] = destructor;
+            return static_cast<int>(index);
+        }
+    } // namespace detail
 
     coroutine_context::coroutine_context() UTIL_CONFIG_NOEXCEPT : runner_ret_code_(0),
                                                                   flags_(0),
                                                                   runner_(UTIL_CONFIG_NULLPTR),
                                                                   priv_data_(UTIL_CONFIG_NULLPTR),
                                                                   private_buffer_size_(0),
+                                                                  stack_offset_(0),
                                                                   caller_(UTIL_CONFIG_NULLPTR),
                                                                   callee_(UTIL_CONFIG_NULLPTR),
                                                                   callee_stack_(),
@@ -72,9 +106,26 @@ namespace copp {
                                                                   caller_stack_(),
 #endif
                                                                   status_(status_t::EN_CRS_INVALID) {
+        memset(local_slots_, 0, sizeof(local_slots_));
     }
 
-    coroutine_context::~coroutine_context() {}
+    coroutine_context::~coroutine_context() { destroy_local_slots(); }
+
+    void coroutine_context::destroy_local_slots() UTIL_CONFIG_NOEXCEPT {
+        detail::coroutine_local_registry_t &registry = detail::get_coroutine_local_registry();
+        size_t slot_count = registry.slot_count.load(util::lock::memory_order_acquire);
+        if (slot_count > COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER) {
+            slot_count = COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER;
+        }
+
+        for (size_t i = 0; i < slot_count; ++i) {
+            if (UTIL_CONFIG_NULLPTR != local_slots_[i] && UTIL_CONFIG_NULLPTR != registry.destructors[i]) {
+                void *value = local_slots_[i];
+                local_slots_[i] = UTIL_CONFIG_NULLPTR;
+                registry.destructors[i](value);
+            }
+        }
+    }
 
     int coroutine_context::create(coroutine_context *p, callback_t &runner, const stack_context &callee_stack, size_t coroutine_size,
                                   size_t private_buffer_size) UTIL_CONFIG_NOEXCEPT {
@@ -115,11 +166,12 @@ namespace copp {
             p->callee_stack_ = callee_stack;
         }
         p->private_buffer_size_ = private_buffer_size;
+        p->stack_offset_ = stack_offset;
 
         // stack down, left enough private data
         p->priv_data_ = reinterpret_cast<unsigned char *>(p->callee_stack_.sp) - p->private_buffer_size_;
-        p->callee_ = fcontext::copp_make_fcontext(reinterpret_cast<unsigned char *>(p->callee_stack_.sp) - stack_offset,
-                                                  p->callee_stack_.size - stack_offset, &coroutine_context::coroutine_context_callback);
+        p->callee_ = fcontext::backend_t::make(reinterpret_cast<unsigned char *>(p->callee_stack_.sp) - stack_offset,
+                                               p->callee_stack_.size - stack_offset, &coroutine_context::coroutine_context_callback);
         if (NULL == p->callee_) {
             return COPP_EC_FCONTEXT_MAKE_FAILED;
         }
@@ -127,7 +179,7 @@ namespace copp {
         return COPP_EC_SUCCESS;
     }
 
-    int coroutine_context::start(void *priv_data) {
+    int coroutine_context::start(void *priv_data, void **yield_data) {
         if (NULL == callee_) {
             return COPP_EC_NOT_INITED;
         }
@@ -179,16 +231,44 @@ namespace copp {
             }
         }
 
+        // jump_to() has replaced jump_data.priv_data with the data from the coroutine which jumps back
+        if (UTIL_CONFIG_NULLPTR != yield_data) {
+            *yield_data = jump_data.priv_data;
+        }
+
         return COPP_EC_SUCCESS;
     }
 
-    int coroutine_context::resume(void *priv_data) { return start(priv_data); }
+    int coroutine_context::unwind(void *priv_data) {
+        if (is_finished()) {
+            return COPP_EC_NOT_READY;
+        }
+
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+        flags_ |= flag_t::EN_CFT_UNWINDING;
+        int ret = start(priv_data);
+        // not switched into the coroutine, it's not unwinding
+        if (ret < 0) {
+            flags_ &= ~flag_t::EN_CFT_UNWINDING;
+        }
+        return ret;
+#else
+        return start(priv_data);
+#endif
+    }
 
-    int coroutine_context::yield(void **priv_data) {
+    int coroutine_context::yield(void **priv_data, void *yield_data) {
         if (UTIL_CONFIG_NULLPTR == callee_) {
             return COPP_EC_NOT_INITED;
         }
 
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+        // a coroutine being unwinded can not be suspended any more
+        if (unlikely(flags_ & flag_t::EN_CFT_UNWINDING) && status_t::EN_CRS_RUNNING == status_.load(util::lock::memory_order_acquire)) {
+            throw detail::forced_unwind();
+        }
+#endif
+
         int from_status = status_t::EN_CRS_RUNNING;
         if (false == status_.compare_exchange_strong(from_status, status_t::EN_CRS_READY, util::lock::memory_order_acq_rel,
                                                      util::lock::memory_order_acquire)) {
@@ -210,6 +290,7 @@ namespace copp {
         jump_src_data_t jump_data;
         jump_data.from_co = this;
         jump_data.to_co = UTIL_CONFIG_NULLPTR;
+        jump_data.priv_data = yield_data;
 
 
 #ifdef COPP_MACRO_USE_SEGMENTED_STACKS
@@ -218,6 +299,13 @@ namespace copp {
         jump_to(caller_, callee_stack_, callee_stack_, jump_data);
 #endif
 
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+        // resumed by unwind()
+        if (unlikely(flags_ & flag_t::EN_CFT_UNWINDING)) {
+            throw detail::forced_unwind();
+        }
+#endif
+
         if (UTIL_CONFIG_NULLPTR != priv_data) {
             *priv_data = jump_data.priv_data;
         }
@@ -243,8 +331,6 @@ namespace copp {
         return true;
     }
 
-    bool coroutine_context::check_flags(int flags) const { return 0 != (flags_ & flags); }
-
 #if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
     int coroutine_context::set_runner(callback_t &&runner) {
 #else
@@ -264,13 +350,73 @@ namespace copp {
         return COPP_EC_SUCCESS;
     }
 
+#if defined(UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES) && UTIL_CONFIG_COMPILER_CXX_RVALUE_REFERENCES
+    int coroutine_context::reset(callback_t &&runner) {
+#else
+    int coroutine_context::reset(const callback_t &runner) {
+#endif
+        if (!runner) {
+            return COPP_EC_ARGS_ERROR;
+        }
+
+        int ret = reset_context();
+        if (ret < 0) {
+            return ret;
+        }
+
+        runner_ = COPP_MACRO_STD_MOVE(runner);
+        status_.store(status_t::EN_CRS_READY, util::lock::memory_order_release);
+        return COPP_EC_SUCCESS;
+    }
+
+    int coroutine_context::restart() {
+        int ret = reset_context();
+        if (ret < 0) {
+            return ret;
+        }
+
+        status_.store(status_t::EN_CRS_READY, util::lock::memory_order_release);
+        return COPP_EC_SUCCESS;
+    }
+
+    int coroutine_context::reset_context() UTIL_CONFIG_NOEXCEPT {
+        if (NULL == callee_stack_.sp || 0 == stack_offset_) {
+            return COPP_EC_NOT_INITED;
+        }
+
+        // nobody can start it until it's ready again
+        int from_status = status_t::EN_CRS_EXITED;
+        if (false == status_.compare_exchange_strong(from_status, status_t::EN_CRS_INVALID, util::lock::memory_order_acq_rel,
+                                                     util::lock::memory_order_acquire)) {
+            // a READY coroutine may be suspended in the middle of the runner, only the one which is not started can be reset
+            if (status_t::EN_CRS_READY != from_status || check_flags(flag_t::EN_CFT_FINISHED) || UTIL_CONFIG_NULLPTR != caller_ ||
+                false == status_.compare_exchange_strong(from_status, status_t::EN_CRS_INVALID, util::lock::memory_order_acq_rel,
+                                                         util::lock::memory_order_acquire)) {
+                return COPP_EC_NOT_READY;
+            }
+        }
+
+        destroy_local_slots();
+        runner_ret_code_ = 0;
+        flags_ &= ~flag_t::EN_CFT_MASK;
+        caller_ = UTIL_CONFIG_NULLPTR;
+        callee_ = fcontext::backend_t::make(reinterpret_cast<unsigned char *>(callee_stack_.sp) - stack_offset_,
+                                            callee_stack_.size - stack_offset_, &coroutine_context::coroutine_context_callback);
+        if (NULL == callee_) {
+            return COPP_EC_FCONTEXT_MAKE_FAILED;
+        }
+
+        return COPP_EC_SUCCESS;
+    }
+
     bool coroutine_context::is_finished() const UTIL_CONFIG_NOEXCEPT {
         // return !!(flags_ & flag_t::EN_CFT_FINISHED);
         return status_.load(util::lock::memory_order_acquire) >= status_t::EN_CRS_FINISHED;
     }
 
-    void coroutine_context::jump_to(fcontext::fcontext_t &to_fctx, stack_context &from_sctx, stack_context &to_sctx,
-                                    jump_src_data_t &jump_transfer) UTIL_CONFIG_NOEXCEPT {
+    // inline into start() and yield(), so there is no call chain in the switch path when inline jump is used
+    inline void coroutine_context::jump_to(fcontext::fcontext_t &to_fctx, stack_context &from_sctx, stack_context &to_sctx,
+                                           jump_src_data_t &jump_transfer) UTIL_CONFIG_NOEXCEPT {
 
         copp::fcontext::transfer_t res;
         jump_src_data_t *jump_src;
@@ -294,7 +440,11 @@ namespace copp {
         }
         __splitstack_setcontext(to_sctx.segments_ctx);
 #endif
-        res = copp::fcontext::copp_jump_fcontext(to_fctx, &jump_transfer);
+#if defined(COPP_FCONTEXT_USE_INLINE_JUMP) && defined(COPP_FCONTEXT_HAS_INLINE_JUMP) && defined(COPP_FCONTEXT_BACKEND_IS_FCONTEXT)
+        res = copp::fcontext::copp_jump_fcontext_inline(to_fctx, &jump_transfer);
+#else
+        res = copp::fcontext::backend_t::jump(to_fctx, &jump_transfer);
+#endif
         if (NULL == res.data) {
             abort();
             return;
@@ -386,7 +536,18 @@ namespace copp {
         detail::set_this_coroutine_context(ins_ptr);
 
         // run logic code
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+        // unwind() before the first start, just finish it
+        if (likely(0 == (ins_ptr->flags_ & flag_t::EN_CFT_UNWINDING))) {
+            try {
+                ins_ptr->run_and_recv_retcode(jump_src.priv_data);
+            } catch (const detail::forced_unwind &) {
+                // stack unwinded by unwind()
+            }
+        }
+#else
         ins_ptr->run_and_recv_retcode(jump_src.priv_data);
+#endif
 
         ins_ptr->flags_ |= flag_t::EN_CFT_FINISHED;
         ins_ptr->status_.store(status_t::EN_CRS_FINISHED, util::lock::memory_order_release);
@@ -398,7 +559,15 @@ namespace copp {
     }
 
     namespace this_coroutine {
+#if !defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
         coroutine_context *get_coroutine() UTIL_CONFIG_NOEXCEPT { return detail::get_this_coroutine_context(); }
+#endif
+
+        coroutine_context *exchange_coroutine(coroutine_context *co) UTIL_CONFIG_NOEXCEPT {
+            coroutine_context *ret = detail::get_this_coroutine_context();
+            detail::set_this_coroutine_context(co);
+            return ret;
+        }
 
         int yield(void **priv_data) {
             coroutine_context *pco = get_coroutine();
@@ -0,0 +1,85 @@
+/*
+ * fcontext_minimal.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#include <cstring>
+
+#include <libcopp/fcontext/backend.hpp>
+
+#if defined(COPP_FCONTEXT_HAS_MINIMAL_BACKEND) && COPP_FCONTEXT_HAS_MINIMAL_BACKEND
+
+#include <stdint.h>
+
+/**
+ * context-data layout, fcontext_t points to R12 and it's always at the top of the suspended stack
+ *  ----------------------------------------------
+ *  |  0x0  |  0x8  |  0x10 |  0x18 |  0x20 |  0x28 |  0x30 |
+ *  ----------------------------------------------
+ *  |  R12  |  R13  |  R14  |  R15  |  RBX  |  RBP  |  RIP  |
+ *  ----------------------------------------------
+ * x87 control word and MXCSR are not saved, so coroutines must not change rounding mode or exception masks.
+ */
+__asm__(".text\n"
+        ".globl copp_jump_fcontext_minimal\n"
+        ".type copp_jump_fcontext_minimal,@function\n"
+        ".align 16\n"
+        "copp_jump_fcontext_minimal:\n"
+        "    pushq %rbp\n"
+        "    pushq %rbx\n"
+        "    pushq %r15\n"
+        "    pushq %r14\n"
+        "    pushq %r13\n"
+        "    pushq %r12\n"
+        // RAX == fctx of this context, RDI == to
+        "    movq %rsp, %rax\n"
+        "    movq %rdi, %rsp\n"
+        "    popq %r12\n"
+        "    popq %r13\n"
+        "    popq %r14\n"
+        "    popq %r15\n"
+        "    popq %rbx\n"
+        "    popq %rbp\n"
+        // return transfer_t { RAX, RDX }, or pass it to copp_fcontext_minimal_trampoline in RDI, RSI
+        // use jmp instead of ret, ret to an address which is not pushed by the paired call always misses the return stack buffer
+        "    popq %r8\n"
+        "    movq %rsi, %rdx\n"
+        "    movq %rax, %rdi\n"
+        "    jmp *%r8\n"
+        ".size copp_jump_fcontext_minimal,.-copp_jump_fcontext_minimal\n"
+
+        ".type copp_fcontext_minimal_trampoline,@function\n"
+        ".align 16\n"
+        "copp_fcontext_minimal_trampoline:\n"
+        // context function is in RBX, transfer_t is already in RDI, RSI
+        "    andq $-16, %rsp\n"
+        "    callq *%rbx\n"
+        // context function must not return
+        "    ud2\n"
+        ".size copp_fcontext_minimal_trampoline,.-copp_fcontext_minimal_trampoline\n");
+
+extern "C" void copp_fcontext_minimal_trampoline();
+
+namespace copp {
+    namespace fcontext {
+        extern "C" fcontext_t copp_make_fcontext_minimal(void *sp, std::size_t size, void (*fn)(transfer_t)) {
+            uintptr_t top = reinterpret_cast<uintptr_t>(sp) & ~static_cast<uintptr_t>(15);
+            if (size < 0x40 + (reinterpret_cast<uintptr_t>(sp) - top)) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            // 6 registers, return address and one slot of padding, so RSP is 16 bytes aligned after the trampoline
+            void **frame = reinterpret_cast<void **>(top - 0x40);
+            memset(frame, 0, 0x40);
+            frame[4] = reinterpret_cast<void *>(fn);
+            frame[6] = reinterpret_cast<void *>(&copp_fcontext_minimal_trampoline);
+            return frame;
+        }
+    } // namespace fcontext
+} // namespace copp
+
+#endif
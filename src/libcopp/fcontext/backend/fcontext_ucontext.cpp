@@ -0,0 +1,90 @@
+/*
+ * fcontext_ucontext.cpp
+ *
+ *  Created on: 2026年10月18日
+ *      Author: owent
+ *
+ *  Released under the MIT license
+ */
+
+#include <cstring>
+
+#include <libcopp/fcontext/backend.hpp>
+
+#if defined(COPP_FCONTEXT_HAS_UCONTEXT_BACKEND) && COPP_FCONTEXT_HAS_UCONTEXT_BACKEND
+
+#include <stdint.h>
+#include <ucontext.h>
+
+namespace copp {
+    namespace fcontext {
+        namespace {
+            /**
+             * @brief context record, fcontext_t of this backend points to it
+             * @note record of a suspended context lives in the stack frame of copp_jump_fcontext_ucontext,
+             *       record of a new context is placed at the top of its stack
+             */
+            struct ucontext_record_t {
+                ucontext_t ctx;
+                transfer_t in; // what the context receives when it's resumed
+                void (*fn)(transfer_t);
+            };
+
+            // makecontext only passes int arguments, so the pointer is split into two halves
+            static void ucontext_trampoline(unsigned int hi, unsigned int lo) {
+                uintptr_t ptr = static_cast<uintptr_t>(lo);
+#if UINTPTR_MAX > 0xFFFFFFFFU
+                ptr |= static_cast<uintptr_t>(hi) << 32;
+#else
+                (void)hi;
+#endif
+                ucontext_record_t *rec = reinterpret_cast<ucontext_record_t *>(ptr);
+                rec->fn(rec->in);
+            }
+        } // namespace
+
+        extern "C" transfer_t copp_jump_fcontext_ucontext(fcontext_t const to, void *vp) {
+            ucontext_record_t *target = reinterpret_cast<ucontext_record_t *>(to);
+            ucontext_record_t  self;
+
+            target->in.fctx = &self;
+            target->in.data = vp;
+            swapcontext(&self.ctx, &target->ctx);
+
+            // resumed by another copp_jump_fcontext_ucontext, which filled self.in
+            return self.in;
+        }
+
+        extern "C" fcontext_t copp_make_fcontext_ucontext(void *sp, std::size_t size, void (*fn)(transfer_t)) {
+            uintptr_t top = reinterpret_cast<uintptr_t>(sp) - sizeof(ucontext_record_t);
+            top &= ~static_cast<uintptr_t>(15);
+
+            unsigned char *stack_bottom = reinterpret_cast<unsigned char *>(sp) - size;
+            if (top <= reinterpret_cast<uintptr_t>(stack_bottom)) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            ucontext_record_t *rec = reinterpret_cast<ucontext_record_t *>(top);
+            memset(rec, 0, sizeof(ucontext_record_t));
+            if (0 != getcontext(&rec->ctx)) {
+                return UTIL_CONFIG_NULLPTR;
+            }
+
+            rec->fn                = fn;
+            rec->ctx.uc_link       = UTIL_CONFIG_NULLPTR;
+            rec->ctx.uc_stack.ss_sp   = stack_bottom;
+            rec->ctx.uc_stack.ss_size = top - reinterpret_cast<uintptr_t>(stack_bottom);
+
+            uintptr_t ptr = reinterpret_cast<uintptr_t>(rec);
+#if UINTPTR_MAX > 0xFFFFFFFFU
+            makecontext(&rec->ctx, reinterpret_cast<void (*)()>(ucontext_trampoline), 2, static_cast<unsigned int>(ptr >> 32),
+                        static_cast<unsigned int>(ptr & 0xFFFFFFFFU));
+#else
+            makecontext(&rec->ctx, reinterpret_cast<void (*)()>(ucontext_trampoline), 2, 0U, static_cast<unsigned int>(ptr));
+#endif
+            return rec;
+        }
+    } // namespace fcontext
+} // namespace copp
+
+#endif
@@ -12,6 +12,16 @@ if (LIBCOPP_FCONTEXT_USE_TSX)
 	set(COPP_FCONTEXT_USE_TSX 1)
 endif()
 
+if (LIBCOPP_FCONTEXT_NO_FPU_CONTROL)
+	EchoWithColor(COLOR GREEN "-- disable saving x87 control word and MXCSR in context switch.")
+	set(COPP_FCONTEXT_NO_FPU_CONTROL 1)
+endif()
+
+if (LIBCOPP_FCONTEXT_USE_INLINE_JUMP)
+	EchoWithColor(COLOR GREEN "-- enable inline asm context switch.")
+	set(COPP_FCONTEXT_USE_INLINE_JUMP 1)
+endif()
+
 # ========== set platform, abi, binary format and as tool ==========
 include("${PROJECT_LIBCOPP_FCONTEXT_SRC_DIR}/detect/fcontext.detect.cmake")
 
@@ -22,13 +32,56 @@ set (PROJECT_LIBCOPP_FCONTEXT_SRC_NAME_ONTOP "ontop_${LIBCOPP_FCONTEXT_OS_PLATFO
 
 include("${PROJECT_LIBCOPP_FCONTEXT_SRC_DIR}/tools/${LIBCOPP_FCONTEXT_AS_TOOL}.cmake")
 
+# ========== context switch backend ==========
+# all available backends are built, so they can be compared by benchmarks, LIBCOPP_FCONTEXT_BACKEND only decides which one is used by coroutine_context
+file(GLOB SRC_LIST "${PROJECT_LIBCOPP_FCONTEXT_SRC_DIR}/backend/*.cpp")
+list(APPEND COPP_SRC_LIST ${SRC_LIST})
+
+if (NOT LIBCOPP_FCONTEXT_BACKEND)
+	set(LIBCOPP_FCONTEXT_BACKEND "fcontext")
+endif()
+string(TOLOWER "${LIBCOPP_FCONTEXT_BACKEND}" LIBCOPP_FCONTEXT_BACKEND)
+unset(COPP_FCONTEXT_BACKEND_UCONTEXT)
+unset(COPP_FCONTEXT_BACKEND_MINIMAL)
+
+if ("${LIBCOPP_FCONTEXT_BACKEND}" STREQUAL "ucontext")
+	if (NOT (WIN32 OR CYGWIN OR APPLE OR ANDROID OR LIBCOPP_ENABLE_SEGMENTED_STACKS))
+		set(COPP_FCONTEXT_BACKEND_UCONTEXT 1)
+	else()
+		EchoWithColor(COLOR YELLOW "-- fcontext.backend ucontext is not available on this platform, use fcontext instead.")
+		set(LIBCOPP_FCONTEXT_BACKEND "fcontext")
+	endif()
+elseif ("${LIBCOPP_FCONTEXT_BACKEND}" STREQUAL "minimal")
+	if ("${LIBCOPP_FCONTEXT_OS_PLATFORM}" STREQUAL "x86_64" AND "${LIBCOPP_FCONTEXT_ABI}" STREQUAL "sysv" AND "${LIBCOPP_FCONTEXT_BIN_FORMAT}" STREQUAL "elf" AND NOT LIBCOPP_ENABLE_SEGMENTED_STACKS)
+		set(COPP_FCONTEXT_BACKEND_MINIMAL 1)
+	else()
+		EchoWithColor(COLOR YELLOW "-- fcontext.backend minimal is only available for x86_64 sysv elf, use fcontext instead.")
+		set(LIBCOPP_FCONTEXT_BACKEND "fcontext")
+	endif()
+elseif (NOT "${LIBCOPP_FCONTEXT_BACKEND}" STREQUAL "fcontext")
+	EchoWithColor(COLOR YELLOW "-- fcontext.backend ${LIBCOPP_FCONTEXT_BACKEND} is invalid, use fcontext instead.")
+	set(LIBCOPP_FCONTEXT_BACKEND "fcontext")
+endif()
+
 # ========== show fcontext info ==========
 EchoWithColor(COLOR GREEN "-- fcontext.os_platform => ${LIBCOPP_FCONTEXT_OS_PLATFORM}")
 EchoWithColor(COLOR GREEN "-- fcontext.abi => ${LIBCOPP_FCONTEXT_ABI}")
 EchoWithColor(COLOR GREEN "-- fcontext.bin_formation => ${LIBCOPP_FCONTEXT_BIN_FORMAT}")
 EchoWithColor(COLOR GREEN "-- fcontext.as_tool => ${LIBCOPP_FCONTEXT_AS_TOOL}")
 EchoWithColor(COLOR GREEN "-- fcontext.as_action => ${LIBCOPP_FCONTEXT_AS_ACTION}")
+EchoWithColor(COLOR GREEN "-- fcontext.backend => ${LIBCOPP_FCONTEXT_BACKEND}")
 EchoWithColor(COLOR GREEN "-- fcontext.use_tsx => ${LIBCOPP_FCONTEXT_USE_TSX}")
+EchoWithColor(COLOR GREEN "-- fcontext.no_fpu_control => ${LIBCOPP_FCONTEXT_NO_FPU_CONTROL}")
+if (LIBCOPP_FCONTEXT_NO_FPU_CONTROL AND NOT ("${LIBCOPP_FCONTEXT_OS_PLATFORM}" STREQUAL "x86_64" AND "${LIBCOPP_FCONTEXT_ABI}" STREQUAL "sysv"))
+	EchoWithColor(COLOR YELLOW "-- fcontext.no_fpu_control is only available for x86_64 sysv, it will be ignored.")
+endif()
+EchoWithColor(COLOR GREEN "-- fcontext.use_inline_jump => ${LIBCOPP_FCONTEXT_USE_INLINE_JUMP}")
+if (LIBCOPP_FCONTEXT_USE_INLINE_JUMP AND NOT ("${LIBCOPP_FCONTEXT_OS_PLATFORM}" STREQUAL "x86_64" AND "${LIBCOPP_FCONTEXT_ABI}" STREQUAL "sysv"))
+	EchoWithColor(COLOR YELLOW "-- fcontext.use_inline_jump is only available for x86_64 sysv, it will be ignored.")
+endif()
+if (LIBCOPP_FCONTEXT_USE_INLINE_JUMP AND NOT "${LIBCOPP_FCONTEXT_BACKEND}" STREQUAL "fcontext")
+	EchoWithColor(COLOR YELLOW "-- fcontext.use_inline_jump is only available for fcontext backend, it will be ignored.")
+endif()
 
 # ========== msvc x86 disable safeseh ==========
 if (MSVC AND "${LIBCOPP_FCONTEXT_OS_PLATFORM}" STREQUAL "i386")
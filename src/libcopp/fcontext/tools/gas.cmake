@@ -31,6 +31,9 @@ unset (LIBCOPP_FCONTEXT_AS_TOOL_OPTION)
 if (LIBCOPP_FCONTEXT_USE_TSX)
     list (APPEND LIBCOPP_FCONTEXT_AS_TOOL_OPTION "-DCOPP_FCONTEXT_USE_TSX=1")
 endif()
+if (LIBCOPP_FCONTEXT_NO_FPU_CONTROL)
+    list (APPEND LIBCOPP_FCONTEXT_AS_TOOL_OPTION "-DCOPP_FCONTEXT_NO_FPU_CONTROL=1")
+endif()
 
 execute_process (
     COMMAND ${LIBCOPP_FCONTEXT_AS_TOOL_BINC} ${LIBCOPP_FCONTEXT_AS_TOOL_OPTION} -c -x assembler-with-cpp "${PROJECT_LIBCOPP_FCONTEXT_ASM_DIR}/${PROJECT_LIBCOPP_FCONTEXT_SRC_FILE_MAKE}" -o "${PROJECT_LIBCOPP_FCONTEXT_BIN_DIR}/${PROJECT_LIBCOPP_FCONTEXT_BIN_NAME_MAKE}"
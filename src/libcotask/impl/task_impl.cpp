@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <deque>
 
 #include <assert.h>
 
@@ -16,10 +17,98 @@
 #include <libcotask/impl/task_action_impl.h>
 #include <libcotask/impl/task_impl.h>
 
+#if ((!defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)) && \
+     !(defined(UTIL_CONFIG_COMPILER_CXX_THREAD_LOCAL) && UTIL_CONFIG_COMPILER_CXX_THREAD_LOCAL)) || \
+    !defined(UTIL_CONFIG_THREAD_LOCAL)
+
+#include <pthread.h>
+
+#endif
 
 namespace cotask {
     namespace impl {
-        task_impl::task_impl() : action_(UTIL_CONFIG_NULLPTR), finish_priv_data_(UTIL_CONFIG_NULLPTR), status_(EN_TS_CREATED) {}
+        namespace detail {
+            // the inline task is not kept in dispatch_context_t, so this_task() out of coroutines is just a TLS load
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+
+            COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC task_impl *gt_current_inline_task = UTIL_CONFIG_NULLPTR;
+
+#elif !defined(UTIL_CONFIG_THREAD_LOCAL)
+
+            static pthread_once_t gt_inline_task_init_once = PTHREAD_ONCE_INIT;
+            static pthread_key_t gt_inline_task_tls_key;
+            static void init_pthread_inline_task() { (void)pthread_key_create(&gt_inline_task_tls_key, UTIL_CONFIG_NULLPTR); }
+
+#else
+
+            static UTIL_CONFIG_THREAD_LOCAL task_impl *gt_current_inline_task = UTIL_CONFIG_NULLPTR;
+
+#endif
+        } // namespace detail
+
+        struct task_impl::dispatch_context_t {
+            EN_TASK_DISPATCH_MODE mode;
+            bool draining;
+            std::deque<dispatch_entry_t> queue;
+
+            dispatch_context_t() : mode(EN_TDM_INLINE), draining(false) {}
+
+            ~dispatch_context_t() {
+                // release references of tasks which will never run
+                while (!queue.empty()) {
+                    dispatch_entry_t entry = queue.front();
+                    queue.pop_front();
+                    entry.dispatch_fn(entry, false);
+                }
+            }
+
+#if (!defined(PROJECT_DISABLE_MT) || !(PROJECT_DISABLE_MT)) && \
+    !(defined(UTIL_CONFIG_COMPILER_CXX_THREAD_LOCAL) && UTIL_CONFIG_COMPILER_CXX_THREAD_LOCAL)
+            static void init_pthread_key();
+            static void destroy_pthread_value(void *p);
+#endif
+        };
+
+#if defined(PROJECT_DISABLE_MT) && PROJECT_DISABLE_MT
+
+        task_impl::dispatch_context_t *task_impl::get_dispatch_context() {
+            static dispatch_context_t ret;
+            return &ret;
+        }
+
+#elif defined(UTIL_CONFIG_COMPILER_CXX_THREAD_LOCAL) && UTIL_CONFIG_COMPILER_CXX_THREAD_LOCAL
+
+        task_impl::dispatch_context_t *task_impl::get_dispatch_context() {
+            static thread_local dispatch_context_t ret;
+            return &ret;
+        }
+
+#else
+
+        static pthread_once_t gt_dispatch_context_init_once = PTHREAD_ONCE_INIT;
+        static pthread_key_t gt_dispatch_context_tls_key;
+
+        void task_impl::dispatch_context_t::init_pthread_key() {
+            (void)pthread_key_create(&gt_dispatch_context_tls_key, destroy_pthread_value);
+        }
+
+        void task_impl::dispatch_context_t::destroy_pthread_value(void *p) { delete reinterpret_cast<dispatch_context_t *>(p); }
+
+        task_impl::dispatch_context_t *task_impl::get_dispatch_context() {
+            (void)pthread_once(&gt_dispatch_context_init_once, dispatch_context_t::init_pthread_key);
+            dispatch_context_t *ret = reinterpret_cast<dispatch_context_t *>(pthread_getspecific(gt_dispatch_context_tls_key));
+            if (UTIL_CONFIG_NULLPTR == ret) {
+                ret = new dispatch_context_t();
+                pthread_setspecific(gt_dispatch_context_tls_key, ret);
+            }
+
+            return ret;
+        }
+
+#endif
+
+        task_impl::task_impl()
+            : action_(UTIL_CONFIG_NULLPTR), type_id_(UTIL_CONFIG_NULLPTR), finish_priv_data_(UTIL_CONFIG_NULLPTR), status_(EN_TS_CREATED) {}
 
         task_impl::~task_impl() { assert(status_ <= EN_TS_CREATED || status_ >= EN_TS_DONE); }
 
@@ -35,18 +124,63 @@ namespace cotask {
 
         int task_impl::on_finished() { return 0; }
 
-        task_impl *task_impl::this_task() {
-            copp::coroutine_context *this_co = copp::this_coroutine::get_coroutine();
-            if (UTIL_CONFIG_NULLPTR == this_co) {
-                return UTIL_CONFIG_NULLPTR;
+        void task_impl::set_dispatch_mode(EN_TASK_DISPATCH_MODE mode) { get_dispatch_context()->mode = mode; }
+
+        EN_TASK_DISPATCH_MODE task_impl::get_dispatch_mode() { return get_dispatch_context()->mode; }
+
+        size_t task_impl::dispatch_pending(size_t max_number) {
+            dispatch_context_t *ctx = get_dispatch_context();
+            // the outer call will run them
+            if (ctx->draining) {
+                return 0;
             }
 
-            if (false == this_co->check_flags(ext_coroutine_flag_t::EN_ECFT_COTASK)) {
-                return UTIL_CONFIG_NULLPTR;
+            // tasks pushed by tasks run here are appended to the queue, so the stack depth is bounded
+            struct draining_guard_t {
+                bool *draining;
+                explicit draining_guard_t(bool *d) : draining(d) { *draining = true; }
+                ~draining_guard_t() { *draining = false; }
+            };
+            draining_guard_t guard(&ctx->draining);
+
+            size_t ret = 0;
+            while (!ctx->queue.empty() && (0 == max_number || ret < max_number)) {
+                // copy it, more entries may be pushed when running it
+                dispatch_entry_t entry = ctx->queue.front();
+                ctx->queue.pop_front();
+                entry.dispatch_fn(entry, true);
+                ++ret;
             }
 
-            return *((task_impl **)this_co->get_private_buffer());
+            return ret;
+        }
+
+        size_t task_impl::get_pending_dispatch_number() { return get_dispatch_context()->queue.size(); }
+
+        void task_impl::_push_dispatch(const dispatch_entry_t &entry) { get_dispatch_context()->queue.push_back(entry); }
+
+        task_impl *task_impl::_exchange_inline_task(task_impl *task) {
+#if defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC) || defined(UTIL_CONFIG_THREAD_LOCAL)
+            task_impl *ret = detail::gt_current_inline_task;
+            detail::gt_current_inline_task = task;
+#else
+            (void)pthread_once(&detail::gt_inline_task_init_once, detail::init_pthread_inline_task);
+            task_impl *ret = reinterpret_cast<task_impl *>(pthread_getspecific(detail::gt_inline_task_tls_key));
+            pthread_setspecific(detail::gt_inline_task_tls_key, task);
+#endif
+            return ret;
+        }
+
+#if !defined(COPP_MACRO_THREAD_LOCAL_INITIAL_EXEC)
+        task_impl *task_impl::_get_inline_task() UTIL_CONFIG_NOEXCEPT {
+#if defined(UTIL_CONFIG_THREAD_LOCAL)
+            return detail::gt_current_inline_task;
+#else
+            (void)pthread_once(&detail::gt_inline_task_init_once, detail::init_pthread_inline_task);
+            return reinterpret_cast<task_impl *>(pthread_getspecific(detail::gt_inline_task_tls_key));
+#endif
         }
+#endif
 
         void task_impl::_set_action(action_ptr_t action) { action_ = action; }
 
@@ -127,3 +127,107 @@ CASE_TEST(coroutine, shared_runner) {
 
     delete[] stack_buff;
 }
+
+static int g_test_coroutine_reset_local_destroyed = 0;
+static void test_context_base_reset_local_destructor(void *) { ++g_test_coroutine_reset_local_destroyed; }
+
+static int test_context_base_reset_runner_a(void *priv_data) {
+    int *counter = reinterpret_cast<int *>(priv_data);
+    ++(*counter);
+    copp::this_coroutine::yield();
+    ++(*counter);
+    return 1;
+}
+
+static int test_context_base_reset_runner_b(void *priv_data) {
+    int *counter = reinterpret_cast<int *>(priv_data);
+    *counter += 10;
+    return 2;
+}
+
+CASE_TEST(coroutine, reset) {
+    int local_index = copp::detail::coroutine_local_alloc_slot(test_context_base_reset_local_destructor);
+    CASE_EXPECT_GE(local_index, 0);
+    g_test_coroutine_reset_local_destroyed = 0;
+
+    int counter = 0;
+    copp::coroutine_context_default::ptr_t co = copp::coroutine_context_default::create(test_context_base_reset_runner_a, 64 * 1024);
+    CASE_EXPECT_TRUE(!!co);
+    void *co_addr = co.get();
+
+    // can not be reset while suspended
+    CASE_EXPECT_EQ(0, co->start(&counter));
+    CASE_EXPECT_EQ(1, counter);
+    CASE_EXPECT_EQ(::copp::COPP_EC_NOT_READY, co->reset(test_context_base_reset_runner_b));
+    if (local_index >= 0) {
+        CASE_EXPECT_EQ(0, co->set_local(static_cast<size_t>(local_index), &counter));
+    }
+    CASE_EXPECT_EQ(0, co->resume(&counter));
+    CASE_EXPECT_EQ(2, counter);
+    CASE_EXPECT_TRUE(co->is_finished());
+    CASE_EXPECT_EQ(1, co->get_ret_code());
+
+    // run a new runner on the same stack
+    CASE_EXPECT_EQ(0, co->reset(test_context_base_reset_runner_b));
+    CASE_EXPECT_EQ(co_addr, co.get());
+    CASE_EXPECT_FALSE(co->is_finished());
+    CASE_EXPECT_EQ(0, co->get_ret_code());
+    if (local_index >= 0) {
+        CASE_EXPECT_EQ(1, g_test_coroutine_reset_local_destroyed);
+        CASE_EXPECT_TRUE(NULL == co->get_local(static_cast<size_t>(local_index)));
+    }
+    CASE_EXPECT_EQ(0, co->start(&counter));
+    CASE_EXPECT_EQ(12, counter);
+    CASE_EXPECT_TRUE(co->is_finished());
+    CASE_EXPECT_EQ(2, co->get_ret_code());
+
+    // keep the runner
+    for (int i = 0; i < 3; ++i) {
+        CASE_EXPECT_EQ(0, co->restart());
+        CASE_EXPECT_EQ(0, co->start(&counter));
+        CASE_EXPECT_EQ(22 + 10 * i, counter);
+    }
+
+    // not started coroutine can be reset too
+    CASE_EXPECT_EQ(0, co->restart());
+    CASE_EXPECT_EQ(0, co->reset(test_context_base_reset_runner_a));
+    CASE_EXPECT_EQ(0, co->start(&counter));
+    CASE_EXPECT_EQ(43, counter);
+    CASE_EXPECT_EQ(0, co->resume(&counter));
+    CASE_EXPECT_EQ(44, counter);
+}
+
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+static int test_context_base_unwind_running_runner(void *priv_data) {
+    int *counter = reinterpret_cast<int *>(priv_data);
+    copp::coroutine_context *self = copp::this_coroutine::get_coroutine();
+
+    // a running coroutine can not be unwinded, and it can still be suspended
+    CASE_EXPECT_EQ(::copp::COPP_EC_IS_RUNNING, self->unwind());
+    CASE_EXPECT_FALSE(self->is_unwinding());
+    ++(*counter);
+    copp::this_coroutine::yield();
+    ++(*counter);
+    return 0;
+}
+
+CASE_TEST(coroutine, unwind_running) {
+    int counter = 0;
+    copp::coroutine_context_default::ptr_t co =
+        copp::coroutine_context_default::create(test_context_base_unwind_running_runner, 64 * 1024);
+    CASE_EXPECT_TRUE(!!co);
+
+    CASE_EXPECT_EQ(0, co->start(&counter));
+    CASE_EXPECT_EQ(1, counter);
+    CASE_EXPECT_FALSE(co->is_finished());
+    CASE_EXPECT_FALSE(co->is_unwinding());
+
+    CASE_EXPECT_EQ(0, co->resume());
+    CASE_EXPECT_EQ(2, counter);
+    CASE_EXPECT_TRUE(co->is_finished());
+
+    // finished coroutine can not be unwinded either
+    CASE_EXPECT_EQ(::copp::COPP_EC_NOT_READY, co->unwind());
+    CASE_EXPECT_FALSE(co->is_unwinding());
+}
+#endif
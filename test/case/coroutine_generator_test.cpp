@@ -0,0 +1,193 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+#include <libcopp/coroutine/generator.h>
+#include <libcopp/coroutine/push_coroutine.h>
+
+typedef copp::generator<int> test_generator_int_type;
+typedef copp::push_coroutine<std::string> test_push_coroutine_string_type;
+
+static int g_test_generator_alive_count = 0;
+
+struct test_generator_alive_guard {
+    test_generator_alive_guard() { ++g_test_generator_alive_count; }
+    test_generator_alive_guard(const test_generator_alive_guard &) { ++g_test_generator_alive_count; }
+    ~test_generator_alive_guard() { --g_test_generator_alive_count; }
+};
+
+static void test_generator_fibonacci(test_generator_int_type::yield_type &yield) {
+    test_generator_alive_guard guard;
+    int a = 0, b = 1;
+    for (int i = 0; i < 10; ++i) {
+        yield(a);
+        int c = a + b;
+        a = b;
+        b = c;
+    }
+}
+
+static const int *g_test_generator_last_addr = NULL;
+
+static void test_generator_zero_copy(test_generator_int_type::yield_type &yield) {
+    int value = 42;
+    g_test_generator_last_addr = &value;
+    yield(value);
+    // consumer reads the value on the stack of the body
+    value = 43;
+    yield(value);
+}
+
+CASE_TEST(coroutine, generator_pull) {
+    std::vector<int> values;
+    {
+        test_generator_int_type gen(test_generator_fibonacci);
+        CASE_EXPECT_TRUE(gen.valid());
+        CASE_EXPECT_EQ(1, g_test_generator_alive_count);
+
+        for (test_generator_int_type::iterator iter = gen.begin(); iter != gen.end(); ++iter) {
+            values.push_back(*iter);
+        }
+
+        CASE_EXPECT_FALSE(gen.valid());
+        CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, gen.next());
+        CASE_EXPECT_EQ(0, g_test_generator_alive_count);
+    }
+
+    CASE_EXPECT_EQ(10, static_cast<int>(values.size()));
+    if (10 == values.size()) {
+        CASE_EXPECT_EQ(0, values[0]);
+        CASE_EXPECT_EQ(1, values[1]);
+        CASE_EXPECT_EQ(1, values[2]);
+        CASE_EXPECT_EQ(34, values[9]);
+    }
+
+    // values are passed by pointer
+    {
+        test_generator_int_type gen(test_generator_zero_copy);
+        CASE_EXPECT_TRUE(gen.valid());
+        CASE_EXPECT_EQ(g_test_generator_last_addr, &gen.get());
+        CASE_EXPECT_EQ(42, gen.get());
+        CASE_EXPECT_EQ(0, gen.next());
+        CASE_EXPECT_EQ(g_test_generator_last_addr, &gen.get());
+        CASE_EXPECT_EQ(43, gen.get());
+        gen.next();
+        CASE_EXPECT_FALSE(gen.valid());
+    }
+}
+
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+CASE_TEST(coroutine, generator_destroy_unfinished) {
+    {
+        test_generator_int_type gen(test_generator_fibonacci);
+        CASE_EXPECT_TRUE(gen.valid());
+        gen.next();
+        CASE_EXPECT_EQ(1, gen.get());
+        CASE_EXPECT_EQ(1, g_test_generator_alive_count);
+    }
+
+    // stack of the body is unwinded
+    CASE_EXPECT_EQ(0, g_test_generator_alive_count);
+}
+#endif
+
+static std::vector<const std::string *> g_test_push_coroutine_addrs;
+static std::string g_test_push_coroutine_joined;
+
+static void test_push_coroutine_join(test_push_coroutine_string_type::pull_type &source) {
+    for (test_push_coroutine_string_type::pull_type::iterator iter = source.begin(); iter != source.end(); ++iter) {
+        g_test_push_coroutine_addrs.push_back(&(*iter));
+        g_test_push_coroutine_joined += *iter;
+    }
+}
+
+static void test_push_coroutine_take_one(test_push_coroutine_string_type::pull_type &source) {
+    g_test_push_coroutine_joined += source.get();
+}
+
+CASE_TEST(coroutine, push_coroutine) {
+    g_test_push_coroutine_addrs.clear();
+    g_test_push_coroutine_joined.clear();
+
+    std::string a = "hello", b = " ", c = "world";
+    {
+        test_push_coroutine_string_type sink(test_push_coroutine_join);
+        CASE_EXPECT_TRUE(sink.valid());
+        // body is not called before the first value
+        CASE_EXPECT_TRUE(g_test_push_coroutine_joined.empty());
+
+        CASE_EXPECT_EQ(0, sink.push(a));
+        CASE_EXPECT_EQ(0, sink(b));
+        CASE_EXPECT_EQ(0, sink(c));
+        CASE_EXPECT_TRUE(sink.valid());
+
+        CASE_EXPECT_EQ(0, sink.close());
+        CASE_EXPECT_FALSE(sink.valid());
+        CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, sink.push(a));
+    }
+
+    CASE_EXPECT_EQ("hello world", g_test_push_coroutine_joined);
+    CASE_EXPECT_EQ(3, static_cast<int>(g_test_push_coroutine_addrs.size()));
+    if (3 == g_test_push_coroutine_addrs.size()) {
+        // values are passed by pointer
+        CASE_EXPECT_EQ(&a, g_test_push_coroutine_addrs[0]);
+        CASE_EXPECT_EQ(&b, g_test_push_coroutine_addrs[1]);
+        CASE_EXPECT_EQ(&c, g_test_push_coroutine_addrs[2]);
+    }
+
+    // body returns before all values are pushed
+    g_test_push_coroutine_joined.clear();
+    {
+        test_push_coroutine_string_type sink(test_push_coroutine_take_one);
+        CASE_EXPECT_EQ(0, sink.push(a));
+        CASE_EXPECT_FALSE(sink.valid());
+        CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, sink.push(b));
+    }
+    CASE_EXPECT_EQ("hello", g_test_push_coroutine_joined);
+
+    // closed without any value
+    g_test_push_coroutine_joined.clear();
+    {
+        test_push_coroutine_string_type sink(test_push_coroutine_take_one);
+    }
+    CASE_EXPECT_TRUE(g_test_push_coroutine_joined.empty());
+}
+
+// larger than the small buffer of std::function, and it's kept in the private buffer of the coroutine
+struct test_generator_large_body {
+    test_generator_large_body() {
+        for (int i = 0; i < 64; ++i) {
+            values[i] = i * i;
+        }
+    }
+
+    void operator()(test_generator_int_type::yield_type &yield) {
+        for (int i = 0; i < 64; ++i) {
+            yield(values[i]);
+        }
+    }
+
+    int values[64];
+    test_generator_alive_guard guard;
+};
+
+CASE_TEST(coroutine, generator_large_body) {
+    {
+        test_generator_large_body body;
+        test_generator_int_type   gen(body);
+        CASE_EXPECT_EQ(2, g_test_generator_alive_count);
+        CASE_EXPECT_TRUE(sizeof(test_generator_large_body) <= gen.get_coroutine()->get_private_buffer_size());
+
+        int sum = 0;
+        for (test_generator_int_type::iterator iter = gen.begin(); iter != gen.end(); ++iter) {
+            sum += *iter;
+        }
+        CASE_EXPECT_EQ(85344, sum);
+    }
+
+    // the body is destroyed with the generator
+    CASE_EXPECT_EQ(0, g_test_generator_alive_count);
+}
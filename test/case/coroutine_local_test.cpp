@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "frame/test_macros.h"
+#include <libcopp/coroutine/coroutine_context_container.h>
+#include <libcopp/coroutine/coroutine_local.h>
+
+typedef copp::coroutine_context_container<copp::allocator::default_statck_allocator> test_coroutine_local_context_type;
+
+static int g_test_coroutine_local_destroyed = 0;
+
+struct test_coroutine_local_span {
+    explicit test_coroutine_local_span(const std::string &n) : name(n) {}
+    ~test_coroutine_local_span() { ++g_test_coroutine_local_destroyed; }
+    std::string name;
+};
+
+static copp::coroutine_local_ptr<test_coroutine_local_span> g_test_coroutine_local_span(
+    copp::coroutine_local_ptr<test_coroutine_local_span>::delete_value);
+static copp::coroutine_local_ptr<int> g_test_coroutine_local_request_id;
+
+static int test_coroutine_local_runner(void *priv_data) {
+    int *request_id = reinterpret_cast<int *>(priv_data);
+    CASE_EXPECT_TRUE(NULL == g_test_coroutine_local_request_id.get());
+    CASE_EXPECT_EQ(0, g_test_coroutine_local_request_id.set(request_id));
+    CASE_EXPECT_EQ(0, g_test_coroutine_local_span.set(new test_coroutine_local_span("span")));
+
+    copp::this_coroutine::yield();
+
+    // values are kept across switches and not mixed between coroutines
+    CASE_EXPECT_EQ(request_id, g_test_coroutine_local_request_id.get());
+    CASE_EXPECT_EQ("span", g_test_coroutine_local_span->name);
+    return 0;
+}
+
+CASE_TEST(coroutine, coroutine_local) {
+    CASE_EXPECT_TRUE(g_test_coroutine_local_span.valid());
+    CASE_EXPECT_TRUE(g_test_coroutine_local_request_id.valid());
+    CASE_EXPECT_NE(g_test_coroutine_local_span.get_index(), g_test_coroutine_local_request_id.get_index());
+
+    // not in coroutine
+    int request_id_main = 0;
+    CASE_EXPECT_TRUE(NULL == g_test_coroutine_local_request_id.get());
+    CASE_EXPECT_EQ(copp::COPP_EC_NOT_RUNNING, g_test_coroutine_local_request_id.set(&request_id_main));
+
+    g_test_coroutine_local_destroyed = 0;
+    int request_id_a = 1, request_id_b = 2;
+    {
+        test_coroutine_local_context_type::ptr_t co_a = test_coroutine_local_context_type::create(test_coroutine_local_runner);
+        test_coroutine_local_context_type::ptr_t co_b = test_coroutine_local_context_type::create(test_coroutine_local_runner);
+
+        co_a->start(&request_id_a);
+        co_b->start(&request_id_b);
+
+        CASE_EXPECT_EQ(&request_id_a, g_test_coroutine_local_request_id.get(*co_a));
+        CASE_EXPECT_EQ(&request_id_b, g_test_coroutine_local_request_id.get(*co_b));
+
+        co_a->resume();
+        co_b->resume();
+        CASE_EXPECT_TRUE(co_a->is_finished());
+        CASE_EXPECT_TRUE(co_b->is_finished());
+
+        // values are destroyed with coroutines, not when runners return
+        CASE_EXPECT_EQ(0, g_test_coroutine_local_destroyed);
+
+        // invalid index
+        CASE_EXPECT_TRUE(NULL == co_a->get_local(COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER));
+        CASE_EXPECT_EQ(copp::COPP_EC_OUT_OF_RANGE, co_a->set_local(COPP_MACRO_COROUTINE_LOCAL_SLOT_NUMBER, &request_id_a));
+    }
+    CASE_EXPECT_EQ(2, g_test_coroutine_local_destroyed);
+}
@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "frame/test_macros.h"
+#include <libcopp/coroutine/pipeline.h>
+
+static copp::pipeline_channel<int> *g_test_pipeline_ch1 = NULL;
+static copp::pipeline_channel<int> *g_test_pipeline_ch2 = NULL;
+static int g_test_pipeline_item_count = 0;
+static int g_test_pipeline_pushed = 0;
+static long long g_test_pipeline_sum = 0;
+static int g_test_pipeline_max_size = 0;
+
+static int test_pipeline_source(void *) {
+    g_test_pipeline_pushed = 0;
+    for (int i = 1; i <= g_test_pipeline_item_count; ++i) {
+        // stop when the reader closes the channel
+        if (0 != g_test_pipeline_ch1->push(i)) {
+            break;
+        }
+        ++g_test_pipeline_pushed;
+    }
+    g_test_pipeline_ch1->close();
+    return 0;
+}
+
+// use span API
+static int test_pipeline_transform(void *) {
+    int *in = NULL;
+    size_t n;
+    while ((n = g_test_pipeline_ch1->acquire_read(in)) > 0) {
+        if (static_cast<int>(g_test_pipeline_ch1->size()) > g_test_pipeline_max_size) {
+            g_test_pipeline_max_size = static_cast<int>(g_test_pipeline_ch1->size());
+        }
+
+        size_t done = 0;
+        while (done < n) {
+            int *out = NULL;
+            size_t m = g_test_pipeline_ch2->acquire_write(out);
+            CASE_EXPECT_NE(0, static_cast<int>(m));
+            if (0 == m) {
+                return -1;
+            }
+            if (m > n - done) {
+                m = n - done;
+            }
+            for (size_t i = 0; i < m; ++i) {
+                out[i] = in[done + i] * 2;
+            }
+            g_test_pipeline_ch2->commit_write(m);
+            done += m;
+        }
+        g_test_pipeline_ch1->commit_read(n);
+    }
+
+    g_test_pipeline_ch2->close();
+    return 0;
+}
+
+static int test_pipeline_sink(void *) {
+    int v;
+    while (0 == g_test_pipeline_ch2->pop(v)) {
+        g_test_pipeline_sum += v;
+    }
+    return 0;
+}
+
+CASE_TEST(coroutine, pipeline) {
+    copp::pipeline_channel<int> ch1(6);
+    copp::pipeline_channel<int> ch2(4);
+    CASE_EXPECT_EQ(8, static_cast<int>(ch1.capacity()));
+    CASE_EXPECT_EQ(4, static_cast<int>(ch2.capacity()));
+
+    g_test_pipeline_ch1 = &ch1;
+    g_test_pipeline_ch2 = &ch2;
+    g_test_pipeline_item_count = 1000;
+    g_test_pipeline_sum = 0;
+    g_test_pipeline_max_size = 0;
+
+    copp::pipeline<> pl;
+    CASE_EXPECT_EQ(0, pl.add_stage(test_pipeline_source, 64 * 1024));
+    CASE_EXPECT_EQ(0, pl.add_stage(test_pipeline_transform, 64 * 1024));
+    CASE_EXPECT_EQ(0, pl.add_stage(test_pipeline_sink, 64 * 1024));
+    CASE_EXPECT_EQ(3, static_cast<int>(pl.size()));
+
+    CASE_EXPECT_EQ(0, pl.run());
+    CASE_EXPECT_EQ(1000, g_test_pipeline_pushed);
+    CASE_EXPECT_EQ(1000LL * 1001, g_test_pipeline_sum);
+    // source fills the whole channel before yielding
+    CASE_EXPECT_EQ(8, g_test_pipeline_max_size);
+    CASE_EXPECT_TRUE(ch1.empty());
+    CASE_EXPECT_TRUE(ch2.empty());
+}
+
+static int test_pipeline_early_sink(void *) {
+    int v;
+    CASE_EXPECT_EQ(0, g_test_pipeline_ch1->pop(v));
+    // stop early, unblock the writer
+    g_test_pipeline_ch1->close();
+    return 0;
+}
+
+CASE_TEST(coroutine, pipeline_backpressure) {
+    copp::pipeline_channel<int> ch1(4);
+    int v = 0;
+    CASE_EXPECT_TRUE(ch1.try_push(1));
+    CASE_EXPECT_TRUE(ch1.try_pop(v));
+    CASE_EXPECT_EQ(1, v);
+    CASE_EXPECT_FALSE(ch1.try_pop(v));
+
+    // not in coroutine, can not wait
+    for (int i = 0; i < 4; ++i) {
+        CASE_EXPECT_EQ(0, ch1.push(i));
+    }
+    CASE_EXPECT_TRUE(ch1.full());
+    CASE_EXPECT_FALSE(ch1.try_push(5));
+    CASE_EXPECT_EQ(copp::COPP_EC_NOT_RUNNING, ch1.push(5));
+    for (int i = 0; i < 4; ++i) {
+        CASE_EXPECT_EQ(0, ch1.pop(v));
+    }
+
+    g_test_pipeline_ch1 = &ch1;
+    g_test_pipeline_item_count = 100;
+
+    copp::pipeline<> pl;
+    pl.add_stage(test_pipeline_source, 64 * 1024);
+    pl.add_stage(test_pipeline_early_sink, 64 * 1024);
+    CASE_EXPECT_EQ(0, pl.run());
+    // source is blocked after the channel is full, and stops after the reader closes the channel
+    CASE_EXPECT_EQ(4, g_test_pipeline_pushed);
+}
+
+static int test_pipeline_unclosed_source(void *) {
+    g_test_pipeline_pushed = 0;
+    for (int i = 1; i <= g_test_pipeline_item_count; ++i) {
+        if (0 != g_test_pipeline_ch1->push(i)) {
+            break;
+        }
+        ++g_test_pipeline_pushed;
+    }
+    // forget to close ch1
+    return 0;
+}
+
+static int test_pipeline_ch1_sink(void *) {
+    int v;
+    while (0 == g_test_pipeline_ch1->pop(v)) {
+        g_test_pipeline_sum += v;
+    }
+    return 0;
+}
+
+// wait for ch1 and write ch2, so two of them wait for each other
+static int test_pipeline_cycle_stage(void *) {
+    int v;
+    if (0 == g_test_pipeline_ch1->pop(v)) {
+        g_test_pipeline_ch2->push(v);
+    }
+    return 0;
+}
+
+static int test_pipeline_cycle_stage_rev(void *) {
+    int v;
+    if (0 == g_test_pipeline_ch2->pop(v)) {
+        g_test_pipeline_ch1->push(v);
+    }
+    return 0;
+}
+
+// yield without any channel before producing, it's not a deadlock
+static int test_pipeline_slow_source(void *) {
+    for (int i = 0; i < 3; ++i) {
+        copp::this_coroutine::yield();
+    }
+    g_test_pipeline_ch1->push(g_test_pipeline_item_count);
+    g_test_pipeline_ch1->close();
+    return 0;
+}
+
+CASE_TEST(coroutine, pipeline_deadlock) {
+    copp::pipeline_channel<int> ch1(4);
+    copp::pipeline_channel<int> ch2(4);
+    g_test_pipeline_ch1 = &ch1;
+    g_test_pipeline_ch2 = &ch2;
+
+    // the reader of a channel which is never closed
+    {
+        g_test_pipeline_item_count = 10;
+        g_test_pipeline_sum = 0;
+
+        copp::pipeline<> pl;
+        pl.add_stage(test_pipeline_unclosed_source, 64 * 1024);
+        pl.add_stage(test_pipeline_ch1_sink, 64 * 1024);
+        CASE_EXPECT_EQ(copp::COPP_EC_DEADLOCK, pl.run());
+        CASE_EXPECT_EQ(10, g_test_pipeline_pushed);
+        CASE_EXPECT_EQ(55, g_test_pipeline_sum);
+    }
+
+    // stages wait for each other
+    {
+        copp::pipeline<> pl;
+        pl.add_stage(test_pipeline_cycle_stage, 64 * 1024);
+        pl.add_stage(test_pipeline_cycle_stage_rev, 64 * 1024);
+        CASE_EXPECT_EQ(copp::COPP_EC_DEADLOCK, pl.run());
+    }
+
+    // stage blocked by channel while the other one yields by itself
+    {
+        copp::pipeline_channel<int> ch3(4);
+        g_test_pipeline_ch1 = &ch3;
+        g_test_pipeline_item_count = 7;
+        g_test_pipeline_sum = 0;
+
+        copp::pipeline<> pl;
+        pl.add_stage(test_pipeline_ch1_sink, 64 * 1024);
+        pl.add_stage(test_pipeline_slow_source, 64 * 1024);
+        CASE_EXPECT_EQ(0, pl.run());
+        CASE_EXPECT_EQ(7, g_test_pipeline_sum);
+    }
+}
@@ -0,0 +1,140 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <libcotask/task.h>
+
+#include "frame/test_macros.h"
+
+static int g_test_task_detach_run       = 0;
+static int g_test_task_detach_destroyed = 0;
+
+struct test_task_detach_action {
+    explicit test_task_detach_action(int yield_times) : yield_times_(yield_times) {}
+    test_task_detach_action(const test_task_detach_action &other) : yield_times_(other.yield_times_) {}
+    ~test_task_detach_action() { ++g_test_task_detach_destroyed; }
+
+    int operator()(void *) {
+        ++g_test_task_detach_run;
+        for (int i = 0; i < yield_times_; ++i) {
+            cotask::this_task::get_task()->yield();
+        }
+        return yield_times_;
+    }
+
+    int yield_times_;
+};
+
+static int test_task_detach_await_action(void *priv_data) {
+    cotask::task<> *other = reinterpret_cast<cotask::task<> *>(priv_data);
+    ++g_test_task_detach_run;
+    return cotask::task<>::this_task()->await(other);
+}
+
+CASE_TEST(coroutine_task, detach) {
+    g_test_task_detach_run       = 0;
+    g_test_task_detach_destroyed = 0;
+
+    cotask::task<>::ptr_t t = cotask::task<>::create(test_task_detach_action(2), 16384);
+    int destroyed           = g_test_task_detach_destroyed;
+    CASE_EXPECT_FALSE(t->is_detached());
+    CASE_EXPECT_EQ(0, t->start());
+    CASE_EXPECT_EQ(0, t->detach());
+    CASE_EXPECT_TRUE(t->is_detached());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_EXIST, t->detach());
+    CASE_EXPECT_EQ(2, (int)t->use_count());
+
+    // no handle is needed any more
+    cotask::task<> *raw = t.get();
+    t.reset();
+    CASE_EXPECT_EQ(1, (int)raw->use_count());
+
+    CASE_EXPECT_EQ(0, raw->resume());
+    CASE_EXPECT_EQ(destroyed, g_test_task_detach_destroyed);
+    CASE_EXPECT_EQ(0, raw->resume());
+
+    // released after it finished
+    CASE_EXPECT_EQ(destroyed + 1, g_test_task_detach_destroyed);
+    CASE_EXPECT_EQ(1, g_test_task_detach_run);
+}
+
+CASE_TEST(coroutine_task, detach_before_start) {
+    g_test_task_detach_run       = 0;
+    g_test_task_detach_destroyed = 0;
+
+    cotask::task<> *raw;
+    {
+        cotask::task<>::ptr_t t = cotask::task<>::create(test_task_detach_action(0), 16384);
+        CASE_EXPECT_EQ(0, t->detach());
+        raw = t.get();
+    }
+
+    int destroyed = g_test_task_detach_destroyed;
+    CASE_EXPECT_EQ(1, (int)raw->use_count());
+    CASE_EXPECT_EQ(0, raw->start());
+    CASE_EXPECT_EQ(destroyed + 1, g_test_task_detach_destroyed);
+    CASE_EXPECT_EQ(1, g_test_task_detach_run);
+
+    // inline tasks are released the same way
+    {
+        cotask::task<>::ptr_t t = cotask::task<>::create_inline(test_task_detach_action(0));
+        CASE_EXPECT_EQ(0, t->detach());
+        raw = t.get();
+    }
+    destroyed = g_test_task_detach_destroyed;
+    CASE_EXPECT_EQ(0, raw->start());
+    CASE_EXPECT_EQ(destroyed + 1, g_test_task_detach_destroyed);
+    CASE_EXPECT_EQ(2, g_test_task_detach_run);
+}
+
+CASE_TEST(coroutine_task, detach_finished_or_killed) {
+    g_test_task_detach_run       = 0;
+    g_test_task_detach_destroyed = 0;
+
+    // the task is still owned by the caller
+    cotask::task<>::ptr_t t = cotask::task<>::create(test_task_detach_action(0), 16384);
+    CASE_EXPECT_EQ(0, t->start());
+    CASE_EXPECT_TRUE(t->is_completed());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, t->detach());
+    CASE_EXPECT_FALSE(t->is_detached());
+    CASE_EXPECT_EQ(1, (int)t->use_count());
+
+    // killed while waiting
+    cotask::task<> *raw;
+    {
+        cotask::task<>::ptr_t killed = cotask::task<>::create(test_task_detach_action(3), 16384);
+        CASE_EXPECT_EQ(0, killed->start());
+        CASE_EXPECT_EQ(0, killed->detach());
+        raw = killed.get();
+    }
+
+    int destroyed = g_test_task_detach_destroyed;
+    CASE_EXPECT_EQ(0, raw->kill());
+    CASE_EXPECT_EQ(destroyed + 1, g_test_task_detach_destroyed);
+}
+
+CASE_TEST(coroutine_task, detach_await) {
+    g_test_task_detach_run       = 0;
+    g_test_task_detach_destroyed = 0;
+
+    cotask::task<>::ptr_t other = cotask::task<>::create(test_task_detach_action(1), 16384);
+    CASE_EXPECT_EQ(0, other->start());
+
+    // the detached task is woken and released by the awaited task
+    {
+        cotask::task<>::ptr_t waiter = cotask::task<>::create(test_task_detach_await_action, 16384);
+        CASE_EXPECT_EQ(0, waiter->start(other.get()));
+        CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+        CASE_EXPECT_EQ(0, waiter->detach());
+    }
+
+    CASE_EXPECT_EQ(2, g_test_task_detach_run);
+    CASE_EXPECT_EQ(0, other->resume());
+    CASE_EXPECT_TRUE(other->is_completed());
+    CASE_EXPECT_EQ(1, (int)other->use_count());
+}
+
+#endif
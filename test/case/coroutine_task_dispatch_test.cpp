@@ -0,0 +1,155 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <libcotask/task.h>
+
+#include "frame/test_macros.h"
+
+static std::vector<int> g_test_task_dispatch_order;
+
+static int test_task_dispatch_action(void *priv_data) {
+    g_test_task_dispatch_order.push_back(static_cast<int>(reinterpret_cast<intptr_t>(priv_data)));
+    return 0;
+}
+
+static int test_task_dispatch_await_action(void *priv_data) {
+    cotask::task<>::self_t *other_task = reinterpret_cast<cotask::task<>::self_t *>(priv_data);
+    int                     ret        = cotask::task<>::this_task()->await(other_task);
+    g_test_task_dispatch_order.push_back(100);
+    return ret;
+}
+
+// inline tasks run on the stack of the one which starts them, the address of a local shows how deep it is
+static std::vector<uintptr_t> g_test_task_dispatch_stack;
+
+static int test_task_dispatch_stack_action(void *) {
+    volatile char mark = 0;
+    g_test_task_dispatch_stack.push_back(reinterpret_cast<uintptr_t>(&mark));
+    return mark;
+}
+
+// max distance between the stack of the first task and the others in a chain of inline tasks
+static size_t test_task_dispatch_chain_depth(int length) {
+    g_test_task_dispatch_stack.clear();
+
+    std::vector<cotask::task<>::ptr_t> chain;
+    for (int i = 0; i < length; ++i) {
+        chain.push_back(cotask::task<>::create_inline(test_task_dispatch_stack_action));
+        if (i > 0) {
+            chain[i - 1]->next(chain[i]);
+        }
+    }
+    CASE_EXPECT_EQ(0, chain[0]->start());
+    CASE_EXPECT_TRUE(chain.back()->is_completed());
+    CASE_EXPECT_EQ(length, static_cast<int>(g_test_task_dispatch_stack.size()));
+
+    size_t ret = 0;
+    for (size_t i = 1; i < g_test_task_dispatch_stack.size(); ++i) {
+        uintptr_t first = g_test_task_dispatch_stack[0];
+        uintptr_t cur   = g_test_task_dispatch_stack[i];
+        size_t    depth = static_cast<size_t>(first > cur ? first - cur : cur - first);
+        if (depth > ret) {
+            ret = depth;
+        }
+    }
+    return ret;
+}
+
+// t0 -> a(1) -> c(3)
+//    -> b(2)
+static void test_task_dispatch_build(std::vector<cotask::task<>::ptr_t> &tasks) {
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back(cotask::task<>::create(test_task_dispatch_action, 16384));
+    }
+
+    tasks[0]->next(tasks[1], reinterpret_cast<void *>(1));
+    tasks[0]->next(tasks[2], reinterpret_cast<void *>(2));
+    tasks[1]->next(tasks[3], reinterpret_cast<void *>(3));
+}
+
+CASE_TEST(coroutine_task, dispatch_inline) {
+    CASE_EXPECT_EQ(cotask::EN_TDM_INLINE, cotask::impl::task_impl::get_dispatch_mode());
+    g_test_task_dispatch_order.clear();
+
+    std::vector<cotask::task<>::ptr_t> tasks;
+    test_task_dispatch_build(tasks);
+    CASE_EXPECT_EQ(0, tasks[0]->start());
+
+    // depth first, in start() of the finished task
+    CASE_EXPECT_EQ(4, static_cast<int>(g_test_task_dispatch_order.size()));
+    if (4 == g_test_task_dispatch_order.size()) {
+        CASE_EXPECT_EQ(1, g_test_task_dispatch_order[1]);
+        CASE_EXPECT_EQ(3, g_test_task_dispatch_order[2]);
+        CASE_EXPECT_EQ(2, g_test_task_dispatch_order[3]);
+    }
+
+    // every task in a chain is started by the previous one, the stack grows with the length of the chain
+    CASE_EXPECT_GT(test_task_dispatch_chain_depth(256), static_cast<size_t>(16 * 1024));
+}
+
+CASE_TEST(coroutine_task, dispatch_trampoline) {
+    cotask::impl::task_impl::set_dispatch_mode(cotask::EN_TDM_TRAMPOLINE);
+    g_test_task_dispatch_order.clear();
+
+    std::vector<cotask::task<>::ptr_t> tasks;
+    test_task_dispatch_build(tasks);
+    CASE_EXPECT_EQ(0, tasks[0]->start());
+
+    // breadth first, the nested dispatch of a is queued
+    CASE_EXPECT_EQ(0, static_cast<int>(cotask::impl::task_impl::get_pending_dispatch_number()));
+    CASE_EXPECT_EQ(4, static_cast<int>(g_test_task_dispatch_order.size()));
+    if (4 == g_test_task_dispatch_order.size()) {
+        CASE_EXPECT_EQ(1, g_test_task_dispatch_order[1]);
+        CASE_EXPECT_EQ(2, g_test_task_dispatch_order[2]);
+        CASE_EXPECT_EQ(3, g_test_task_dispatch_order[3]);
+    }
+
+    // a long chain does not recurse, all the tasks after the first one are started by the same dispatch loop
+    CASE_EXPECT_LT(test_task_dispatch_chain_depth(256), static_cast<size_t>(4096));
+
+    cotask::impl::task_impl::set_dispatch_mode(cotask::EN_TDM_INLINE);
+}
+
+CASE_TEST(coroutine_task, dispatch_deferred) {
+    cotask::impl::task_impl::set_dispatch_mode(cotask::EN_TDM_DEFERRED);
+    g_test_task_dispatch_order.clear();
+
+    std::vector<cotask::task<>::ptr_t> tasks;
+    test_task_dispatch_build(tasks);
+    CASE_EXPECT_EQ(0, tasks[0]->start());
+
+    // nothing runs until the scheduler dispatches them
+    CASE_EXPECT_EQ(1, static_cast<int>(g_test_task_dispatch_order.size()));
+    CASE_EXPECT_EQ(2, static_cast<int>(cotask::impl::task_impl::get_pending_dispatch_number()));
+    CASE_EXPECT_EQ(cotask::EN_TS_CREATED, tasks[1]->get_status());
+
+    CASE_EXPECT_EQ(1, static_cast<int>(cotask::impl::task_impl::dispatch_pending(1)));
+    CASE_EXPECT_EQ(2, static_cast<int>(g_test_task_dispatch_order.size()));
+    CASE_EXPECT_EQ(2, static_cast<int>(cotask::impl::task_impl::get_pending_dispatch_number()));
+
+    CASE_EXPECT_EQ(2, static_cast<int>(cotask::impl::task_impl::dispatch_pending()));
+    CASE_EXPECT_EQ(0, static_cast<int>(cotask::impl::task_impl::get_pending_dispatch_number()));
+    CASE_EXPECT_EQ(4, static_cast<int>(g_test_task_dispatch_order.size()));
+    CASE_EXPECT_TRUE(tasks[3]->is_completed());
+
+    // awaiting tasks are woken by the scheduler too
+    g_test_task_dispatch_order.clear();
+    cotask::task<>::ptr_t target = cotask::task<>::create(test_task_dispatch_action, 16384);
+    cotask::task<>::ptr_t waiter = cotask::task<>::create(test_task_dispatch_await_action, 16384);
+    CASE_EXPECT_EQ(0, waiter->start(target.get()));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+    CASE_EXPECT_EQ(0, target->start());
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+    CASE_EXPECT_EQ(1, static_cast<int>(cotask::impl::task_impl::dispatch_pending()));
+    CASE_EXPECT_TRUE(waiter->is_completed());
+    CASE_EXPECT_EQ(0, waiter->get_ret_code());
+    CASE_EXPECT_EQ(100, g_test_task_dispatch_order.back());
+
+    cotask::impl::task_impl::set_dispatch_mode(cotask::EN_TDM_INLINE);
+}
+
+#endif
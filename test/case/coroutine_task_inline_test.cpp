@@ -0,0 +1,124 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <libcotask/task.h>
+#include <libcotask/task_manager.h>
+
+#include "frame/test_macros.h"
+
+static int g_test_task_inline_run = 0;
+
+static int test_task_inline_action(void *priv_data) {
+    ++g_test_task_inline_run;
+
+    // running on the stack of caller
+    CASE_EXPECT_TRUE(NULL == copp::this_coroutine::get_coroutine());
+    CASE_EXPECT_TRUE(NULL != cotask::this_task::get_task());
+    if (NULL != cotask::this_task::get_task()) {
+        CASE_EXPECT_EQ(cotask::EN_TS_RUNNING, cotask::this_task::get_task()->get_status());
+        CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_INLINE, cotask::this_task::get_task()->yield());
+    }
+
+    return static_cast<int>(reinterpret_cast<intptr_t>(priv_data));
+}
+
+static int test_task_inline_await_action(void *priv_data) {
+    cotask::task<> *other = reinterpret_cast<cotask::task<> *>(priv_data);
+    return cotask::task<>::this_task()->await(other);
+}
+
+static int test_task_inline_stackful_action(void *priv_data) {
+    cotask::task<> *inline_task = reinterpret_cast<cotask::task<> *>(priv_data);
+    cotask::impl::task_impl *self = cotask::this_task::get_task();
+
+    // this_task() is restored after the inline task returned
+    CASE_EXPECT_EQ(0, inline_task->start(reinterpret_cast<void *>(7)));
+    CASE_EXPECT_EQ(self, cotask::this_task::get_task());
+    CASE_EXPECT_EQ(0, cotask::this_task::get_task()->yield());
+    return inline_task->get_ret_code();
+}
+
+CASE_TEST(coroutine_task, inline_task) {
+    g_test_task_inline_run = 0;
+
+    cotask::task<>::ptr_t t = cotask::task<>::create_inline(test_task_inline_action);
+    CASE_EXPECT_TRUE(!!t);
+    CASE_EXPECT_TRUE(t->is_inline());
+    CASE_EXPECT_FALSE(t->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_CREATED, t->get_status());
+
+    CASE_EXPECT_EQ(0, t->start(reinterpret_cast<void *>(3)));
+    CASE_EXPECT_EQ(1, g_test_task_inline_run);
+    CASE_EXPECT_TRUE(t->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_DONE, t->get_status());
+    CASE_EXPECT_EQ(3, t->get_ret_code());
+    CASE_EXPECT_FALSE(t->get_coroutine_context());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, t->start());
+    CASE_EXPECT_TRUE(NULL == cotask::this_task::get_task());
+
+    // await() is not allowed in inline tasks
+    cotask::task<>::ptr_t other = cotask::task<>::create_inline(test_task_inline_action);
+    cotask::task<>::ptr_t t2    = cotask::task<>::create_inline(test_task_inline_await_action);
+    CASE_EXPECT_EQ(0, t2->start(other.get()));
+    CASE_EXPECT_TRUE(t2->is_completed());
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_INLINE, t2->get_ret_code());
+
+    // killed before started
+    CASE_EXPECT_EQ(0, other->kill());
+    CASE_EXPECT_TRUE(other->is_completed());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, other->start());
+    CASE_EXPECT_EQ(1, g_test_task_inline_run);
+}
+
+CASE_TEST(coroutine_task, inline_task_in_stackful) {
+    g_test_task_inline_run = 0;
+
+    cotask::task<>::ptr_t inline_task = cotask::task<>::create_inline(test_task_inline_action);
+    cotask::task<>::ptr_t stackful    = cotask::task<>::create(test_task_inline_stackful_action, 16384);
+
+    CASE_EXPECT_EQ(0, stackful->start(inline_task.get()));
+    CASE_EXPECT_EQ(1, g_test_task_inline_run);
+    CASE_EXPECT_TRUE(inline_task->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_WAITING, stackful->get_status());
+    CASE_EXPECT_EQ(0, stackful->resume());
+    CASE_EXPECT_EQ(7, stackful->get_ret_code());
+}
+
+CASE_TEST(coroutine_task, inline_task_next_and_await) {
+    g_test_task_inline_run = 0;
+
+    // inline -> inline -> stackful
+    cotask::task<>::ptr_t t1 = cotask::task<>::create_inline(test_task_inline_action);
+    cotask::task<>::ptr_t t2 = cotask::task<>::create_inline(test_task_inline_action);
+    cotask::task<>::ptr_t t3 = cotask::task<>::create(test_task_inline_await_action, 16384);
+    cotask::task<>::ptr_t t4 = cotask::task<>::create_inline(test_task_inline_action);
+    t1->next(t2, reinterpret_cast<void *>(2))->next(t3, t4.get());
+
+    CASE_EXPECT_EQ(0, t1->start());
+    CASE_EXPECT_TRUE(t2->is_completed());
+    CASE_EXPECT_EQ(2, t2->get_ret_code());
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, t3->get_status());
+
+    // the stackful task is woken by the inline task
+    CASE_EXPECT_EQ(0, t4->start());
+    CASE_EXPECT_TRUE(t3->is_completed());
+    CASE_EXPECT_EQ(0, t3->get_ret_code());
+    CASE_EXPECT_EQ(3, g_test_task_inline_run);
+
+    // task manager
+    typedef cotask::task_manager<cotask::task<> > mgr_t;
+    mgr_t::ptr_t                                  task_mgr = mgr_t::create();
+
+    cotask::task<>::ptr_t t5 = cotask::task<>::create_inline(test_task_inline_action);
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t5, 10, 0));
+    CASE_EXPECT_EQ(1, (int)task_mgr->get_task_size());
+    CASE_EXPECT_EQ(0, task_mgr->start(t5->get_id(), reinterpret_cast<void *>(5)));
+    CASE_EXPECT_EQ(0, (int)task_mgr->get_task_size());
+    CASE_EXPECT_EQ(5, t5->get_ret_code());
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <libcopp/stack/stack_pool.h>
+#include <libcotask/task.h>
+
+#include "frame/test_macros.h"
+
+typedef copp::stack_pool<copp::allocator::stack_allocator_malloc> test_task_lazy_stack_pool_t;
+struct test_task_lazy_macro_coroutine {
+    typedef copp::allocator::stack_allocator_pool<test_task_lazy_stack_pool_t> stack_allocator_t;
+
+    typedef copp::coroutine_context_container<stack_allocator_t> coroutine_t;
+};
+
+typedef cotask::task<test_task_lazy_macro_coroutine> test_task_lazy_task_t;
+
+static int g_test_task_lazy_run = 0;
+
+struct test_task_lazy_action {
+    int operator()(void *) {
+        CASE_EXPECT_TRUE(NULL != cotask::this_task::get_task());
+        CASE_EXPECT_EQ(cotask::EN_TS_RUNNING, cotask::this_task::get_task()->get_status());
+        ++g_test_task_lazy_run;
+        cotask::this_task::get_task()->yield();
+        ++g_test_task_lazy_run;
+        return 3;
+    }
+};
+
+CASE_TEST(coroutine_task, lazy_stack) {
+    test_task_lazy_stack_pool_t::ptr_t stack_pool = test_task_lazy_stack_pool_t::create();
+    stack_pool->set_stack_size(64 * 1024);
+    g_test_task_lazy_run = 0;
+
+    std::vector<test_task_lazy_task_t::ptr_t> tasks;
+    for (int i = 0; i < 16; ++i) {
+        copp::allocator::stack_allocator_pool<test_task_lazy_stack_pool_t> alloc(stack_pool);
+        tasks.push_back(test_task_lazy_task_t::create_lazy(test_task_lazy_action(), alloc));
+        CASE_EXPECT_TRUE(!!tasks.back());
+    }
+
+    // no stack before started
+    CASE_EXPECT_EQ(0, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_TRUE(tasks[0]->is_lazy());
+    CASE_EXPECT_FALSE(tasks[0]->get_coroutine_context());
+    CASE_EXPECT_TRUE(NULL == tasks[0]->get_private_buffer());
+    CASE_EXPECT_FALSE(tasks[0]->is_completed());
+
+    for (int i = 0; i < 4; ++i) {
+        CASE_EXPECT_EQ(0, tasks[i]->start());
+    }
+    CASE_EXPECT_EQ(4, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_EQ(4, g_test_task_lazy_run);
+    CASE_EXPECT_TRUE(!!tasks[0]->get_coroutine_context());
+
+    for (int i = 0; i < 4; ++i) {
+        CASE_EXPECT_EQ(0, tasks[i]->resume());
+        CASE_EXPECT_TRUE(tasks[i]->is_completed());
+        CASE_EXPECT_EQ(3, tasks[i]->get_ret_code());
+    }
+    CASE_EXPECT_EQ(8, g_test_task_lazy_run);
+
+    // stacks are released when tasks finished, not when tasks are destroyed
+    CASE_EXPECT_EQ(0, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_FALSE(tasks[0]->get_coroutine_context());
+    CASE_EXPECT_TRUE(tasks[0]->is_completed());
+    CASE_EXPECT_EQ(3, tasks[0]->get_ret_code());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, tasks[0]->start());
+
+    // killed before started, never get a stack
+    CASE_EXPECT_EQ(0, tasks[4]->kill());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, tasks[4]->start());
+    CASE_EXPECT_FALSE(tasks[4]->get_coroutine_context());
+    CASE_EXPECT_TRUE(tasks[4]->is_completed());
+
+    // killed while waiting, the stack is released after it's finished
+    CASE_EXPECT_EQ(0, tasks[5]->start());
+    CASE_EXPECT_EQ(1, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_EQ(0, tasks[5]->kill());
+    CASE_EXPECT_EQ(0, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_TRUE(tasks[5]->is_completed());
+
+    tasks.clear();
+    CASE_EXPECT_EQ(0, stack_pool->get_limit().used_stack_number);
+}
+
+CASE_TEST(coroutine_task, lazy_stack_alloc_failed) {
+    test_task_lazy_stack_pool_t::ptr_t stack_pool = test_task_lazy_stack_pool_t::create();
+    stack_pool->set_stack_size(64 * 1024);
+    stack_pool->set_max_stack_number(1);
+    g_test_task_lazy_run = 0;
+
+    copp::allocator::stack_allocator_pool<test_task_lazy_stack_pool_t> alloc(stack_pool);
+    test_task_lazy_task_t::ptr_t t1 = test_task_lazy_task_t::create_lazy(test_task_lazy_action(), alloc);
+    test_task_lazy_task_t::ptr_t t2 = test_task_lazy_task_t::create_lazy(test_task_lazy_action(), alloc);
+
+    CASE_EXPECT_EQ(0, t1->start());
+    CASE_EXPECT_EQ(copp::COPP_EC_ALLOC_STACK_FAILED, t2->start());
+    CASE_EXPECT_EQ(cotask::EN_TS_CREATED, t2->get_status());
+
+    // t1 gives its stack back when it's finished
+    t1->resume();
+    CASE_EXPECT_TRUE(t1->is_completed());
+
+    // retry after a stack is available
+    CASE_EXPECT_EQ(0, t2->start());
+    CASE_EXPECT_EQ(0, t2->resume());
+    CASE_EXPECT_TRUE(t2->is_completed());
+    CASE_EXPECT_EQ(4, g_test_task_lazy_run);
+}
+
+CASE_TEST(coroutine_task, lazy_stack_next) {
+    test_task_lazy_stack_pool_t::ptr_t stack_pool = test_task_lazy_stack_pool_t::create();
+    stack_pool->set_stack_size(64 * 1024);
+    stack_pool->set_max_stack_number(1);
+    g_test_task_lazy_run = 0;
+
+    // a chain of tasks runs with one stack
+    copp::allocator::stack_allocator_pool<test_task_lazy_stack_pool_t> alloc(stack_pool);
+    test_task_lazy_task_t::ptr_t t1 = test_task_lazy_task_t::create_lazy(test_task_lazy_action(), alloc);
+    test_task_lazy_task_t::ptr_t t2 = test_task_lazy_task_t::create_lazy(test_task_lazy_action(), alloc);
+    test_task_lazy_task_t::ptr_t t3 = test_task_lazy_task_t::create_lazy(test_task_lazy_action(), alloc);
+    t1->next(t2)->next(t3);
+
+    CASE_EXPECT_EQ(0, t1->start());
+    CASE_EXPECT_EQ(0, t1->resume());
+    CASE_EXPECT_EQ(cotask::EN_TS_WAITING, t2->get_status());
+    CASE_EXPECT_EQ(0, t2->resume());
+    CASE_EXPECT_EQ(0, t3->resume());
+
+    CASE_EXPECT_TRUE(t1->is_completed());
+    CASE_EXPECT_TRUE(t2->is_completed());
+    CASE_EXPECT_TRUE(t3->is_completed());
+    CASE_EXPECT_EQ(6, g_test_task_lazy_run);
+    CASE_EXPECT_EQ(0, stack_pool->get_limit().used_stack_number);
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include <libcopp/utils/std/smart_ptr.h>
+
+#include "frame/test_macros.h"
+#include <libcotask/task_pool.h>
+
+static int g_test_coroutine_task_pool_run       = 0;
+static int g_test_coroutine_task_pool_destroyed = 0;
+
+struct test_context_task_pool_functor {
+    explicit test_context_task_pool_functor(int v) : value(v) {}
+    test_context_task_pool_functor(const test_context_task_pool_functor &other) : value(other.value) {}
+    ~test_context_task_pool_functor() { ++g_test_coroutine_task_pool_destroyed; }
+
+    int operator()(void *) {
+        g_test_coroutine_task_pool_run += value;
+        cotask::this_task::get_task()->yield();
+        g_test_coroutine_task_pool_run += value;
+        return value;
+    }
+
+    int value;
+};
+
+typedef cotask::task_pool<test_context_task_pool_functor> test_context_task_pool_t;
+
+CASE_TEST(coroutine_task, task_pool) {
+    g_test_coroutine_task_pool_run       = 0;
+    g_test_coroutine_task_pool_destroyed = 0;
+
+    test_context_task_pool_t::ptr_t pool = test_context_task_pool_t::create(64 * 1024);
+    CASE_EXPECT_EQ(0, pool->get_free_number());
+
+    test_context_task_pool_t::task_ptr_t t1 = pool->create_task(test_context_task_pool_functor(1));
+    CASE_EXPECT_TRUE(!!t1);
+    void *co_addr = t1->get_coroutine_context().get();
+    uint64_t t1_id = t1->get_id();
+
+    CASE_EXPECT_EQ(0, t1->start());
+    CASE_EXPECT_EQ(0, t1->resume());
+    CASE_EXPECT_TRUE(t1->is_completed());
+    CASE_EXPECT_EQ(1, t1->get_ret_code());
+    CASE_EXPECT_EQ(2, g_test_coroutine_task_pool_run);
+
+    int destroyed = g_test_coroutine_task_pool_destroyed;
+    t1.reset();
+    CASE_EXPECT_EQ(destroyed + 1, g_test_coroutine_task_pool_destroyed);
+    CASE_EXPECT_EQ(1, pool->get_free_number());
+
+    // reuse the stack, new action and new id
+    test_context_task_pool_t::task_ptr_t t2 = pool->create_task(test_context_task_pool_functor(10));
+    CASE_EXPECT_TRUE(!!t2);
+    CASE_EXPECT_EQ(0, pool->get_free_number());
+    CASE_EXPECT_EQ(co_addr, t2->get_coroutine_context().get());
+    CASE_EXPECT_NE(t1_id, t2->get_id());
+    CASE_EXPECT_EQ(cotask::EN_TS_CREATED, t2->get_status());
+
+    CASE_EXPECT_EQ(0, t2->start());
+    CASE_EXPECT_EQ(12, g_test_coroutine_task_pool_run);
+    CASE_EXPECT_EQ(0, t2->resume());
+    CASE_EXPECT_EQ(22, g_test_coroutine_task_pool_run);
+    CASE_EXPECT_EQ(10, t2->get_ret_code());
+
+    // not started and killed tasks are recycled too
+    test_context_task_pool_t::task_ptr_t t3 = pool->create_task(test_context_task_pool_functor(100));
+    test_context_task_pool_t::task_ptr_t t4 = pool->create_task(test_context_task_pool_functor(1000));
+    CASE_EXPECT_EQ(0, t4->start());
+    CASE_EXPECT_EQ(1022, g_test_coroutine_task_pool_run);
+    CASE_EXPECT_EQ(0, t4->kill());
+    CASE_EXPECT_TRUE(t4->is_completed());
+    CASE_EXPECT_EQ(2022, g_test_coroutine_task_pool_run);
+
+    t2.reset();
+    t3.reset();
+    t4.reset();
+    CASE_EXPECT_EQ(3, pool->get_free_number());
+
+    // limit of cached coroutines
+    pool->set_max_free_number(1);
+    test_context_task_pool_t::task_ptr_t t5 = pool->create_task(test_context_task_pool_functor(0));
+    test_context_task_pool_t::task_ptr_t t6 = pool->create_task(test_context_task_pool_functor(0));
+    test_context_task_pool_t::task_ptr_t t7 = pool->create_task(test_context_task_pool_functor(0));
+    CASE_EXPECT_EQ(0, pool->get_free_number());
+    t5.reset();
+    t6.reset();
+    CASE_EXPECT_EQ(1, pool->get_free_number());
+
+    // tasks keep the pool alive
+    test_context_task_pool_t *raw_pool = pool.get();
+    pool.reset();
+    CASE_EXPECT_EQ(0, t7->start());
+    CASE_EXPECT_EQ(0, t7->resume());
+    CASE_EXPECT_TRUE(t7->is_completed());
+    CASE_EXPECT_EQ(1, raw_pool->get_free_number());
+    t7.reset();
+}
+
+#endif
@@ -0,0 +1,178 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <libcopp/stack/stack_pool.h>
+#include <libcotask/task.h>
+
+#include "frame/test_macros.h"
+
+static int g_test_task_result_destroyed = 0;
+
+struct test_task_result_value {
+    explicit test_task_result_value(int v = 0) : value(v), text(static_cast<size_t>(v > 0 ? v : 0), 'x') {}
+    ~test_task_result_value() { ++g_test_task_result_destroyed; }
+
+    int         value;
+    std::string text;
+};
+
+struct test_task_result_action {
+    explicit test_task_result_action(int v) : value(v) {}
+
+    test_task_result_value operator()(void *) {
+        cotask::this_task::get_task()->yield();
+        return test_task_result_value(value);
+    }
+
+    int value;
+};
+
+static std::string test_task_result_string_action(void *) { return std::string("hello"); }
+
+static int test_task_result_when_all_action(void *priv_data) {
+    std::vector<cotask::task<>::ptr_t> *tasks = reinterpret_cast<std::vector<cotask::task<>::ptr_t> *>(priv_data);
+    int                                 ret   = cotask::task<>::this_task()->when_all(*tasks);
+
+    int sum = 0;
+    for (size_t i = 0; i < tasks->size(); ++i) {
+        test_task_result_value *res = (*tasks)[i]->get_result<test_task_result_value>();
+        CASE_EXPECT_TRUE(NULL != res);
+        if (NULL != res) {
+            sum += res->value;
+        }
+    }
+
+    return 0 == ret ? sum : ret;
+}
+
+static int test_task_result_next_action(void *priv_data) {
+    // priv_data of next() is the task finished just now
+    cotask::task<>::self_t *prev = reinterpret_cast<cotask::task<>::self_t *>(priv_data);
+    test_task_result_value *res  = prev->get_result<test_task_result_value>();
+    return NULL == res ? -1 : res->value;
+}
+
+CASE_TEST(coroutine_task, result) {
+    g_test_task_result_destroyed = 0;
+    {
+        cotask::task<>::ptr_t t = cotask::task<>::create_with_result<test_task_result_value>(test_task_result_action(5), 16384);
+        CASE_EXPECT_TRUE(!!t);
+        CASE_EXPECT_TRUE(NULL == t->get_result<test_task_result_value>());
+
+        CASE_EXPECT_EQ(0, t->start());
+        CASE_EXPECT_TRUE(NULL == t->get_result<test_task_result_value>());
+        CASE_EXPECT_EQ(0, t->resume());
+        CASE_EXPECT_TRUE(t->is_completed());
+
+        // wrong type
+        CASE_EXPECT_TRUE(NULL == t->get_result<int>());
+
+        const cotask::task<> *ct = t.get();
+        CASE_EXPECT_TRUE(NULL != ct->get_result<test_task_result_value>());
+        if (NULL != t->get_result<test_task_result_value>()) {
+            CASE_EXPECT_EQ(5, t->get_result<test_task_result_value>()->value);
+            CASE_EXPECT_EQ("xxxxx", t->get_result<test_task_result_value>()->text);
+        }
+
+        // move out
+        int                    destroyed = g_test_task_result_destroyed;
+        test_task_result_value out;
+        CASE_EXPECT_TRUE(t->take_result(out));
+        CASE_EXPECT_EQ(5, out.value);
+        CASE_EXPECT_EQ("xxxxx", out.text);
+        CASE_EXPECT_EQ(destroyed + 1, g_test_task_result_destroyed);
+        CASE_EXPECT_TRUE(NULL == t->get_result<test_task_result_value>());
+        CASE_EXPECT_FALSE(t->take_result(out));
+
+        // function
+        cotask::task<>::ptr_t t2 = cotask::task<>::create_with_result<std::string>(test_task_result_string_action, 16384);
+        CASE_EXPECT_EQ(0, t2->start());
+        CASE_EXPECT_TRUE(NULL != t2->get_result<std::string>());
+        if (NULL != t2->get_result<std::string>()) {
+            CASE_EXPECT_EQ("hello", *t2->get_result<std::string>());
+        }
+    }
+
+    // the result is destroyed with the task
+    {
+        cotask::task<>::ptr_t t = cotask::task<>::create_with_result<test_task_result_value>(test_task_result_action(1), 16384);
+        t->start();
+        t->resume();
+        int destroyed = g_test_task_result_destroyed;
+        t.reset();
+        CASE_EXPECT_EQ(destroyed + 1, g_test_task_result_destroyed);
+    }
+
+    // killed before the action returns, no result
+    cotask::task<>::ptr_t t = cotask::task<>::create_with_result<test_task_result_value>(test_task_result_action(1), 16384);
+    t->set_unwind_on_kill(true);
+    CASE_EXPECT_EQ(0, t->start());
+    CASE_EXPECT_EQ(0, t->kill());
+    CASE_EXPECT_TRUE(t->is_completed());
+    CASE_EXPECT_TRUE(NULL == t->get_result<test_task_result_value>());
+}
+
+CASE_TEST(coroutine_task, result_await) {
+    std::vector<cotask::task<>::ptr_t> tasks;
+    for (int i = 1; i <= 3; ++i) {
+        tasks.push_back(cotask::task<>::create_with_result<test_task_result_value>(test_task_result_action(i), 16384));
+        CASE_EXPECT_EQ(0, tasks.back()->start());
+    }
+
+    cotask::task<>::ptr_t waiter = cotask::task<>::create(test_task_result_when_all_action, 16384);
+    CASE_EXPECT_EQ(0, waiter->start(&tasks));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        CASE_EXPECT_EQ(0, tasks[i]->resume());
+    }
+
+    CASE_EXPECT_TRUE(waiter->is_completed());
+    CASE_EXPECT_EQ(6, waiter->get_ret_code());
+}
+
+CASE_TEST(coroutine_task, result_next) {
+    cotask::task<>::ptr_t t1 = cotask::task<>::create_with_result<test_task_result_value>(test_task_result_action(7), 16384);
+    cotask::task<>::ptr_t t2 = cotask::task<>::create(test_task_result_next_action, 16384);
+    t1->next(t2, t1.get());
+
+    CASE_EXPECT_EQ(0, t1->start());
+    CASE_EXPECT_EQ(0, t1->resume());
+    CASE_EXPECT_TRUE(t2->is_completed());
+    CASE_EXPECT_EQ(7, t2->get_ret_code());
+}
+
+typedef copp::stack_pool<copp::allocator::stack_allocator_malloc> test_task_result_stack_pool_t;
+struct test_task_result_macro_coroutine {
+    typedef copp::allocator::stack_allocator_pool<test_task_result_stack_pool_t> stack_allocator_t;
+
+    typedef copp::coroutine_context_container<stack_allocator_t> coroutine_t;
+};
+
+CASE_TEST(coroutine_task, result_lazy) {
+    typedef cotask::task<test_task_result_macro_coroutine>                             task_t;
+    typedef cotask::task_action_result<test_task_result_value, test_task_result_action> action_t;
+
+    test_task_result_stack_pool_t::ptr_t stack_pool = test_task_result_stack_pool_t::create();
+    stack_pool->set_stack_size(64 * 1024);
+
+    copp::allocator::stack_allocator_pool<test_task_result_stack_pool_t> alloc(stack_pool);
+    task_t::ptr_t t = task_t::create_lazy_with_delegate<action_t>(test_task_result_action(3), alloc);
+    CASE_EXPECT_EQ(0, t->start());
+    CASE_EXPECT_EQ(1, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_EQ(0, t->resume());
+
+    // the stack is released, but the result is kept
+    CASE_EXPECT_EQ(0, stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_TRUE(NULL != t->get_result<test_task_result_value>());
+    if (NULL != t->get_result<test_task_result_value>()) {
+        CASE_EXPECT_EQ(3, t->get_result<test_task_result_value>()->value);
+    }
+}
+
+#endif
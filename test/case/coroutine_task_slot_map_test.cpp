@@ -0,0 +1,199 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <libcotask/task.h>
+#include <libcotask/task_manager.h>
+#include <libcotask/task_slot_map.h>
+
+#include "frame/test_macros.h"
+
+#if ((defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1800)) && \
+    defined(UTIL_CONFIG_COMPILER_CXX_LAMBDAS) && UTIL_CONFIG_COMPILER_CXX_LAMBDAS
+#include <atomic>
+#include <thread>
+#endif
+
+typedef cotask::task<cotask::macro_coroutine, cotask::macro_task_slot> test_slot_task_t;
+typedef cotask::task_slot_map<test_slot_task_t>                         test_slot_map_t;
+typedef cotask::task_manager<test_slot_task_t, test_slot_map_t>         test_slot_mgr_t;
+
+static int g_test_task_slot_map_status = 0;
+
+static int test_task_slot_map_action(void *) {
+    ++g_test_task_slot_map_status;
+    cotask::this_task::get_task()->yield();
+    ++g_test_task_slot_map_status;
+    return 0;
+}
+
+CASE_TEST(coroutine_task, slot_id_allocator) {
+    typedef cotask::core::standard_int_id_slot_allocator<uint64_t> alloc_t;
+    alloc_t                                                          alloc;
+
+    uint64_t id1 = alloc.allocate();
+    uint64_t id2 = alloc.allocate();
+    CASE_EXPECT_NE(0, id1);
+    CASE_EXPECT_NE(id1, id2);
+    CASE_EXPECT_NE(alloc_t::get_index(id1), alloc_t::get_index(id2));
+
+    // the slot is reused with a new generation
+    alloc.deallocate(id1);
+    uint64_t id3 = alloc.allocate();
+    CASE_EXPECT_NE(id1, id3);
+    CASE_EXPECT_EQ(alloc_t::get_index(id1), alloc_t::get_index(id3));
+    CASE_EXPECT_NE(alloc_t::get_generation(id1), alloc_t::get_generation(id3));
+
+    // stale ids do not release the slot again
+    alloc.deallocate(id1);
+    uint64_t id4 = alloc.allocate();
+    CASE_EXPECT_NE(alloc_t::get_index(id3), alloc_t::get_index(id4));
+
+    alloc.deallocate(id2);
+    alloc.deallocate(id3);
+    alloc.deallocate(id4);
+}
+
+CASE_TEST(coroutine_task, slot_map) {
+    test_slot_map_t slots;
+    CASE_EXPECT_TRUE(slots.empty());
+
+    std::vector<test_slot_task_t::ptr_t> tasks;
+    for (int i = 0; i < 8; ++i) {
+        tasks.push_back(test_slot_task_t::create(test_task_slot_map_action, 16384));
+
+        cotask::task_mgr_node<test_slot_task_t> node;
+        node.task_ = tasks.back();
+        CASE_EXPECT_TRUE(slots.insert(test_slot_map_t::value_type(tasks.back()->get_id(), node)).second);
+    }
+    CASE_EXPECT_EQ(8, (int)slots.size());
+
+    // already exists
+    cotask::task_mgr_node<test_slot_task_t> node;
+    node.task_ = tasks[0];
+    CASE_EXPECT_FALSE(slots.insert(test_slot_map_t::value_type(tasks[0]->get_id(), node)).second);
+
+    CASE_EXPECT_EQ(tasks[3].get(), slots.get_task(tasks[3]->get_id()));
+    CASE_EXPECT_EQ(1, (int)slots.erase(tasks[3]->get_id()));
+    CASE_EXPECT_EQ(0, (int)slots.erase(tasks[3]->get_id()));
+    CASE_EXPECT_TRUE(slots.end() == slots.find(tasks[3]->get_id()));
+
+    std::set<uint64_t> ids;
+    for (test_slot_map_t::const_iterator iter = slots.begin(); iter != slots.end(); ++iter) {
+        CASE_EXPECT_EQ(iter->first, iter->second.task_->get_id());
+        ids.insert(iter->first);
+    }
+    CASE_EXPECT_EQ(7, (int)ids.size());
+    CASE_EXPECT_TRUE(ids.end() == ids.find(tasks[3]->get_id()));
+
+    // stale id of a destroyed task is not found by the task using the same slot
+    uint64_t stale_id = tasks[3]->get_id();
+    tasks[3].reset();
+    test_slot_task_t::ptr_t reused = test_slot_task_t::create(test_task_slot_map_action, 16384);
+    CASE_EXPECT_EQ(test_slot_task_t::id_allocator_t::get_index(stale_id), test_slot_task_t::id_allocator_t::get_index(reused->get_id()));
+    node.task_ = reused;
+    CASE_EXPECT_TRUE(slots.insert(test_slot_map_t::value_type(reused->get_id(), node)).second);
+    CASE_EXPECT_TRUE(NULL == slots.get_task(stale_id));
+    CASE_EXPECT_EQ(reused.get(), slots.get_task(reused->get_id()));
+
+    slots.clear();
+    CASE_EXPECT_TRUE(slots.empty());
+    CASE_EXPECT_TRUE(slots.begin() == slots.end());
+}
+
+CASE_TEST(coroutine_task, slot_map_task_manager) {
+    g_test_task_slot_map_status = 0;
+    test_slot_mgr_t::ptr_t task_mgr = test_slot_mgr_t::create();
+
+    test_slot_task_t::ptr_t t1 = test_slot_task_t::create(test_task_slot_map_action, 16384);
+    test_slot_task_t::ptr_t t2 = test_slot_task_t::create(test_task_slot_map_action, 16384);
+    test_slot_task_t::ptr_t t3 = test_slot_task_t::create(test_task_slot_map_action, 16384);
+
+    task_mgr->tick(10);
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t1, 5, 0));
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t2, 20, 0));
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t3));
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_EXIST, task_mgr->add_task(t3));
+    CASE_EXPECT_EQ(3, (int)task_mgr->get_task_size());
+    CASE_EXPECT_EQ(t2, task_mgr->find_task(t2->get_id()));
+
+    CASE_EXPECT_EQ(0, task_mgr->start(t1->get_id()));
+    CASE_EXPECT_EQ(0, task_mgr->start(t2->get_id()));
+    CASE_EXPECT_EQ(0, task_mgr->start(t3->get_id()));
+
+    // timeout
+    task_mgr->tick(16);
+    CASE_EXPECT_EQ(cotask::EN_TS_TIMEOUT, t1->get_status());
+    CASE_EXPECT_EQ(2, (int)task_mgr->get_task_size());
+
+    // finished tasks are removed
+    CASE_EXPECT_EQ(0, task_mgr->resume(t2->get_id()));
+    CASE_EXPECT_EQ(cotask::EN_TS_DONE, t2->get_status());
+    CASE_EXPECT_EQ(1, (int)task_mgr->get_task_size());
+    CASE_EXPECT_EQ(copp::COPP_EC_NOT_FOUND, task_mgr->resume(t2->get_id()));
+
+    // stale id
+    uint64_t stale_id = t2->get_id();
+    t2.reset();
+    CASE_EXPECT_EQ(copp::COPP_EC_NOT_FOUND, task_mgr->kill(stale_id));
+    CASE_EXPECT_TRUE(NULL == task_mgr->get_container().get_task(stale_id));
+
+    CASE_EXPECT_EQ(t3.get(), task_mgr->get_container().get_task(t3->get_id()));
+    task_mgr->reset();
+    CASE_EXPECT_EQ(cotask::EN_TS_KILLED, t3->get_status());
+    CASE_EXPECT_EQ(0, (int)task_mgr->get_task_size());
+    CASE_EXPECT_EQ(6, g_test_task_slot_map_status);
+}
+
+#if ((defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1800)) && \
+    defined(UTIL_CONFIG_COMPILER_CXX_LAMBDAS) && UTIL_CONFIG_COMPILER_CXX_LAMBDAS
+
+CASE_TEST(coroutine_task, slot_id_released_by_other_thread) {
+    typedef cotask::core::standard_int_id_slot_allocator<uint64_t> alloc_t;
+
+    // tasks are created by this thread and released by the worker, like an acceptor and a worker pool
+    std::vector<test_slot_task_t::ptr_t> tasks;
+    std::atomic<int>                     round(0);
+    std::atomic<int>                     released(0);
+    const int                            round_number = 64;
+    std::thread                          worker([&tasks, &round, &released, round_number]() {
+        for (int i = 1; i <= round_number; ++i) {
+            while (round.load() < i) {
+                std::this_thread::yield();
+            }
+            tasks.clear();
+            released.store(i);
+        }
+    });
+
+    uint64_t first_max_index = 0;
+    uint64_t max_index       = 0;
+    for (int i = 1; i <= round_number; ++i) {
+        for (int j = 0; j < 256; ++j) {
+            tasks.push_back(test_slot_task_t::create(test_task_slot_map_action, 16384));
+            if (alloc_t::get_index(tasks.back()->get_id()) > max_index) {
+                max_index = alloc_t::get_index(tasks.back()->get_id());
+            }
+        }
+        if (1 == i) {
+            first_max_index = max_index;
+        }
+
+        round.store(i);
+        while (released.load() < i) {
+            std::this_thread::yield();
+        }
+    }
+    worker.join();
+
+    // slots released by the worker are reused, the max index does not grow with the number of created tasks
+    CASE_EXPECT_LT(max_index, first_max_index + 256);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,287 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <libcotask/task.h>
+#include <libcotask/task_manager.h>
+
+#include "frame/test_macros.h"
+
+#if defined(COPP_MACRO_ENABLE_STD_COROUTINE) && COPP_MACRO_ENABLE_STD_COROUTINE
+
+static int g_test_task_stackless_run       = 0;
+static int g_test_task_stackless_destroyed = 0;
+
+struct test_task_stackless_guard {
+    ~test_task_stackless_guard() { ++g_test_task_stackless_destroyed; }
+};
+
+static cotask::stackless_routine test_task_stackless_yield_action(void *) {
+    test_task_stackless_guard guard;
+    ++g_test_task_stackless_run;
+    co_await std::suspend_always();
+    ++g_test_task_stackless_run;
+    co_return 3;
+}
+
+static cotask::stackless_routine test_task_stackless_await_action(void *priv_data) {
+    cotask::task<>::ptr_t other(reinterpret_cast<cotask::task<> *>(priv_data));
+    ++g_test_task_stackless_run;
+    int ret = co_await other;
+    ++g_test_task_stackless_run;
+    co_return 0 == ret ? other->get_ret_code() : ret;
+}
+
+static int test_task_stackless_stackful_yield_action(void *) {
+    ++g_test_task_stackless_run;
+    cotask::this_task::get_task()->yield();
+    ++g_test_task_stackless_run;
+    return 5;
+}
+
+static int test_task_stackless_stackful_await_action(void *priv_data) {
+    cotask::task<> *other = reinterpret_cast<cotask::task<> *>(priv_data);
+    int             ret   = cotask::task<>::this_task()->await(other);
+    ++g_test_task_stackless_run;
+    return 0 == ret ? other->get_ret_code() : ret;
+}
+
+CASE_TEST(coroutine_task, stackless) {
+    g_test_task_stackless_run       = 0;
+    g_test_task_stackless_destroyed = 0;
+
+    cotask::task<>::ptr_t t = cotask::task<>::create_stackless(test_task_stackless_yield_action);
+    CASE_EXPECT_TRUE(!!t);
+    CASE_EXPECT_TRUE(t->is_stackless());
+    CASE_EXPECT_FALSE(t->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_CREATED, t->get_status());
+
+    CASE_EXPECT_EQ(0, t->start());
+    CASE_EXPECT_EQ(1, g_test_task_stackless_run);
+    CASE_EXPECT_EQ(cotask::EN_TS_WAITING, t->get_status());
+    CASE_EXPECT_FALSE(t->get_coroutine_context());
+    CASE_EXPECT_TRUE(NULL == t->get_private_buffer());
+
+    CASE_EXPECT_EQ(0, t->resume());
+    CASE_EXPECT_EQ(2, g_test_task_stackless_run);
+    CASE_EXPECT_TRUE(t->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_DONE, t->get_status());
+    CASE_EXPECT_EQ(3, t->get_ret_code());
+
+    // the frame is released when it finished
+    CASE_EXPECT_EQ(1, g_test_task_stackless_destroyed);
+    CASE_EXPECT_EQ(copp::COPP_EC_ALREADY_FINISHED, t->start());
+
+    // killed while suspended, local variables are destroyed
+    cotask::task<>::ptr_t killed = cotask::task<>::create_stackless(test_task_stackless_yield_action);
+    CASE_EXPECT_EQ(0, killed->start());
+    CASE_EXPECT_EQ(0, killed->kill());
+    CASE_EXPECT_TRUE(killed->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_KILLED, killed->get_status());
+    CASE_EXPECT_EQ(2, g_test_task_stackless_destroyed);
+    CASE_EXPECT_EQ(3, g_test_task_stackless_run);
+}
+
+CASE_TEST(coroutine_task, stackless_await_stackful) {
+    g_test_task_stackless_run = 0;
+
+    cotask::task<>::ptr_t stackful  = cotask::task<>::create(test_task_stackless_stackful_yield_action, 16384);
+    cotask::task<>::ptr_t stackless = cotask::task<>::create_stackless(test_task_stackless_await_action);
+
+    CASE_EXPECT_EQ(0, stackful->start());
+    CASE_EXPECT_EQ(0, stackless->start(stackful.get()));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, stackless->get_status());
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_AWAITING, stackless->resume());
+    CASE_EXPECT_EQ(2, g_test_task_stackless_run);
+
+    // woken by the stackful task when it finished
+    CASE_EXPECT_EQ(0, stackful->resume());
+    CASE_EXPECT_TRUE(stackless->is_completed());
+    CASE_EXPECT_EQ(5, stackless->get_ret_code());
+    CASE_EXPECT_EQ(4, g_test_task_stackless_run);
+
+    // the awaited task is already finished
+    cotask::task<>::ptr_t stackless2 = cotask::task<>::create_stackless(test_task_stackless_await_action);
+    CASE_EXPECT_EQ(0, stackless2->start(stackful.get()));
+    CASE_EXPECT_TRUE(stackless2->is_completed());
+    CASE_EXPECT_EQ(5, stackless2->get_ret_code());
+}
+
+CASE_TEST(coroutine_task, stackful_await_stackless) {
+    g_test_task_stackless_run = 0;
+
+    cotask::task<>::ptr_t stackless = cotask::task<>::create_stackless(test_task_stackless_yield_action);
+    cotask::task<>::ptr_t stackful  = cotask::task<>::create(test_task_stackless_stackful_await_action, 16384);
+
+    CASE_EXPECT_EQ(0, stackless->start());
+    CASE_EXPECT_EQ(0, stackful->start(stackless.get()));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, stackful->get_status());
+
+    CASE_EXPECT_EQ(0, stackless->resume());
+    CASE_EXPECT_TRUE(stackful->is_completed());
+    CASE_EXPECT_EQ(3, stackful->get_ret_code());
+    CASE_EXPECT_EQ(3, g_test_task_stackless_run);
+
+    // when_all with both kinds of tasks
+    std::vector<cotask::task<>::ptr_t> tasks;
+    tasks.push_back(cotask::task<>::create_stackless(test_task_stackless_yield_action));
+    tasks.push_back(cotask::task<>::create(test_task_stackless_stackful_yield_action, 16384));
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i]->start();
+    }
+
+    cotask::task<>::ptr_t waiter = cotask::task<>::create_stackless(test_task_stackless_await_action);
+    waiter->next(stackful);
+    CASE_EXPECT_EQ(0, waiter->start(tasks[0].get()));
+    tasks[1]->resume();
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+    tasks[0]->resume();
+    CASE_EXPECT_TRUE(waiter->is_completed());
+    CASE_EXPECT_EQ(3, waiter->get_ret_code());
+}
+
+CASE_TEST(coroutine_task, stackless_task_manager) {
+    g_test_task_stackless_run       = 0;
+    g_test_task_stackless_destroyed = 0;
+
+    typedef cotask::task_manager<cotask::task<> > mgr_t;
+    mgr_t::ptr_t                                  task_mgr = mgr_t::create();
+
+    cotask::task<>::ptr_t t1 = cotask::task<>::create_stackless(test_task_stackless_yield_action);
+    cotask::task<>::ptr_t t2 = cotask::task<>::create_stackless(test_task_stackless_yield_action);
+    cotask::task<>::ptr_t t3 = cotask::task<>::create(test_task_stackless_stackful_yield_action, 16384);
+    CASE_EXPECT_NE(t1->get_id(), t2->get_id());
+
+    task_mgr->tick(10);
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t1, 5, 0));
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t2, 20, 0));
+    CASE_EXPECT_EQ(0, task_mgr->add_task(t3, 20, 0));
+
+    CASE_EXPECT_EQ(0, task_mgr->start(t1->get_id()));
+    CASE_EXPECT_EQ(0, task_mgr->start(t2->get_id()));
+    CASE_EXPECT_EQ(0, task_mgr->start(t3->get_id()));
+
+    // timeout
+    task_mgr->tick(16);
+    CASE_EXPECT_EQ(cotask::EN_TS_TIMEOUT, t1->get_status());
+    CASE_EXPECT_TRUE(t1->is_completed());
+    CASE_EXPECT_EQ(1, g_test_task_stackless_destroyed);
+
+    // kill
+    CASE_EXPECT_EQ(0, task_mgr->kill(t2->get_id()));
+    CASE_EXPECT_EQ(cotask::EN_TS_KILLED, t2->get_status());
+    CASE_EXPECT_EQ(2, g_test_task_stackless_destroyed);
+
+    CASE_EXPECT_EQ(0, task_mgr->resume(t3->get_id()));
+    CASE_EXPECT_EQ(0, (int)task_mgr->get_task_size());
+}
+
+typedef cotask::task<cotask::macro_coroutine, cotask::macro_task_slot> test_task_stackless_other_t;
+
+static int test_task_stackless_other_yield_action(void *) {
+    cotask::this_task::get_task()->yield();
+    return 7;
+}
+
+static cotask::stackless_routine test_task_stackless_await_other_action(void *priv_data) {
+    test_task_stackless_other_t::ptr_t other(reinterpret_cast<test_task_stackless_other_t *>(priv_data));
+    ++g_test_task_stackless_run;
+    int ret = co_await other;
+    ++g_test_task_stackless_run;
+    co_return 0 == ret ? other->get_ret_code() : ret;
+}
+
+CASE_TEST(coroutine_task, stackless_await_other_type) {
+    g_test_task_stackless_run = 0;
+
+    test_task_stackless_other_t::ptr_t other  = test_task_stackless_other_t::create(test_task_stackless_other_yield_action, 16384);
+    cotask::task<>::ptr_t              waiter = cotask::task<>::create_stackless(test_task_stackless_await_other_action);
+    cotask::task<>::ptr_t              next   = cotask::task<>::create(test_task_stackless_stackful_yield_action, 16384);
+    waiter->next(next);
+
+    // the waiter is parked, and can not be resumed before the awaited task finished
+    CASE_EXPECT_EQ(0, other->start());
+    CASE_EXPECT_EQ(0, waiter->start(other.get()));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_AWAITING, waiter->resume());
+    CASE_EXPECT_EQ(1, g_test_task_stackless_run);
+
+    // woken and finished by itself, next tasks run
+    CASE_EXPECT_EQ(0, other->resume());
+    CASE_EXPECT_TRUE(waiter->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_DONE, waiter->get_status());
+    CASE_EXPECT_EQ(7, waiter->get_ret_code());
+    CASE_EXPECT_EQ(cotask::EN_TS_WAITING, next->get_status());
+    CASE_EXPECT_EQ(3, g_test_task_stackless_run);
+    CASE_EXPECT_EQ(1, (int)waiter->use_count());
+    CASE_EXPECT_EQ(0, next->resume());
+
+    // the awaited task is already finished
+    cotask::task<>::ptr_t waiter2 = cotask::task<>::create_stackless(test_task_stackless_await_other_action);
+    CASE_EXPECT_EQ(0, waiter2->start(other.get()));
+    CASE_EXPECT_TRUE(waiter2->is_completed());
+    CASE_EXPECT_EQ(7, waiter2->get_ret_code());
+    CASE_EXPECT_EQ(1, (int)waiter2->use_count());
+
+    // killed while awaiting
+    test_task_stackless_other_t::ptr_t other2  = test_task_stackless_other_t::create(test_task_stackless_other_yield_action, 16384);
+    cotask::task<>::ptr_t              waiter3 = cotask::task<>::create_stackless(test_task_stackless_await_other_action);
+    CASE_EXPECT_EQ(0, other2->start());
+    CASE_EXPECT_EQ(0, waiter3->start(other2.get()));
+    CASE_EXPECT_EQ(0, waiter3->kill());
+    CASE_EXPECT_EQ(cotask::EN_TS_KILLED, waiter3->get_status());
+    CASE_EXPECT_EQ(0, other2->resume());
+    CASE_EXPECT_EQ(cotask::EN_TS_KILLED, waiter3->get_status());
+    CASE_EXPECT_EQ(1, (int)waiter3->use_count());
+
+    // the awaited task is never started, and it's released with the frame
+    cotask::task<>::ptr_t waiter4 = cotask::task<>::create_stackless(test_task_stackless_await_other_action);
+    {
+        test_task_stackless_other_t::ptr_t other3 = test_task_stackless_other_t::create(test_task_stackless_other_yield_action, 16384);
+        CASE_EXPECT_EQ(0, waiter4->start(other3.get()));
+        CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter4->get_status());
+    }
+    CASE_EXPECT_EQ(2, (int)waiter4->use_count());
+    CASE_EXPECT_EQ(0, waiter4->kill());
+    CASE_EXPECT_EQ(1, (int)waiter4->use_count());
+}
+
+// a C++20 coroutine which is not run by a task
+struct test_task_stackless_detached {
+    struct promise_type {
+        test_task_stackless_detached get_return_object() { return test_task_stackless_detached(); }
+        std::suspend_never           initial_suspend() noexcept { return std::suspend_never(); }
+        std::suspend_never           final_suspend() noexcept { return std::suspend_never(); }
+        void                         return_void() {}
+        void                         unhandled_exception() { std::terminate(); }
+    };
+};
+
+static test_task_stackless_detached test_task_stackless_detached_action(cotask::task<>::ptr_t t, int *out) {
+    int ret = co_await t;
+    *out    = 0 == ret ? t->get_ret_code() : ret;
+}
+
+CASE_TEST(coroutine_task, stackless_foreign_coroutine) {
+    cotask::task<>::ptr_t t = cotask::task<>::create(test_task_stackless_stackful_yield_action, 16384);
+    CASE_EXPECT_EQ(0, t->start());
+
+    int out = 0;
+    test_task_stackless_detached_action(t, &out);
+    CASE_EXPECT_EQ(0, out);
+
+    CASE_EXPECT_EQ(0, t->resume());
+    CASE_EXPECT_EQ(5, out);
+
+    // finished task does not suspend the coroutine
+    out = 0;
+    test_task_stackless_detached_action(t, &out);
+    CASE_EXPECT_EQ(5, out);
+}
+
+#endif
+
+#endif
@@ -3,6 +3,7 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 #include <libcopp/utils/std/smart_ptr.h>
 
@@ -132,6 +133,43 @@ CASE_TEST(coroutine_task, functor_action) {
     CASE_EXPECT_NE(co_task->get_id(), 0);
 }
 
+struct test_context_task_batch_functor {
+    explicit test_context_task_batch_functor(int i) : index(i) {}
+
+    int operator()(void *) {
+        cotask::this_task::get_task()->yield();
+        return index;
+    }
+
+    int index;
+};
+
+static test_context_task_batch_functor test_context_task_batch_factory(size_t i) {
+    return test_context_task_batch_functor(static_cast<int>(i));
+}
+
+CASE_TEST(coroutine_task, create_batch) {
+    std::vector<cotask::task<>::ptr_t> tasks = cotask::task<>::create_batch(8, test_context_task_batch_factory, 64 * 1024);
+    CASE_EXPECT_EQ(8, tasks.size());
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        CASE_EXPECT_EQ(0, tasks[i]->start());
+        CASE_EXPECT_EQ(cotask::EN_TS_WAITING, tasks[i]->get_status());
+        if (i > 0) {
+            CASE_EXPECT_NE(tasks[i - 1]->get_id(), tasks[i]->get_id());
+        }
+    }
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        CASE_EXPECT_EQ(0, tasks[i]->resume());
+        CASE_EXPECT_TRUE(tasks[i]->is_completed());
+        CASE_EXPECT_EQ(static_cast<int>(i), tasks[i]->get_ret_code());
+    }
+
+    // stack is too small
+    CASE_EXPECT_TRUE(cotask::task<>::create_batch(8, test_context_task_batch_factory, 64).empty());
+}
+
 
 static int test_context_task_function_1(void *) {
     ++g_test_coroutine_task_status;
@@ -233,6 +271,39 @@ CASE_TEST(coroutine_task, coroutine_context_yield) {
     CASE_EXPECT_NE(co_task->get_id(), 0);
 }
 
+struct test_context_task_other_macro_task {
+    typedef uint64_t                                          id_t;
+    typedef cotask::core::standard_int_id_allocator<uint64_t> id_allocator_t;
+};
+typedef cotask::task<cotask::macro_coroutine, test_context_task_other_macro_task> test_context_task_other_t;
+
+static int test_context_task_type_tag_action(void *) {
+    // the type tag of the running task is checked
+    CASE_EXPECT_TRUE(NULL != cotask::task<>::this_task());
+    CASE_EXPECT_TRUE(NULL == test_context_task_other_t::this_task());
+    CASE_EXPECT_EQ(cotask::this_task::get_task(), cotask::this_task::get<cotask::task<> >());
+    CASE_EXPECT_EQ(cotask::this_task::get_task(), cotask::this_task::get<cotask::impl::task_impl>());
+    CASE_EXPECT_TRUE(NULL == cotask::this_task::get<test_context_task_other_t>());
+    CASE_EXPECT_EQ(&cotask::impl::task_result_type_id<cotask::task<> >::value, cotask::this_task::get_task()->get_type_id());
+    return 0;
+}
+
+CASE_TEST(coroutine_task, this_task_type_tag) {
+    CASE_EXPECT_TRUE(NULL == cotask::task<>::this_task());
+    CASE_EXPECT_TRUE(NULL == cotask::this_task::get<cotask::task<> >());
+
+    cotask::task<>::ptr_t co_task = cotask::task<>::create(test_context_task_type_tag_action, 16384);
+    CASE_EXPECT_EQ(0, co_task->start());
+    CASE_EXPECT_TRUE(co_task->is_completed());
+
+    cotask::task<>::ptr_t inline_task = cotask::task<>::create_inline(test_context_task_type_tag_action);
+    CASE_EXPECT_EQ(0, inline_task->start());
+    CASE_EXPECT_TRUE(inline_task->is_completed());
+
+    test_context_task_other_t::ptr_t other = test_context_task_other_t::create(test_context_task_type_tag_action, 16384);
+    CASE_EXPECT_NE(other->get_type_id(), co_task->get_type_id());
+}
+
 
 struct test_context_task_mem_function {
     cotask::task<>::id_t task_id_;
@@ -523,4 +594,257 @@ CASE_TEST(coroutine_task, await) {
     }
 }
 
+static int g_test_context_task_await_wake = 0;
+static int test_context_task_await_parked(void *priv_data) {
+    cotask::task<>::self_t *other_task = reinterpret_cast<cotask::task<>::self_t *>(priv_data);
+    int                     ret        = cotask::task<>::this_task()->await(other_task);
+    ++g_test_context_task_await_wake;
+    return ret;
+}
+
+static int test_context_task_await_target(void *) {
+    cotask::task<>::this_task()->yield();
+    cotask::task<>::this_task()->yield();
+    return 0;
+}
+
+CASE_TEST(coroutine_task, await_suspend) {
+    typedef cotask::task<>::ptr_t task_ptr_type;
+    g_test_context_task_await_wake = 0;
+
+    task_ptr_type target   = cotask::task<>::create(test_context_task_await_target, 16384);
+    task_ptr_type waiter_1 = cotask::task<>::create(test_context_task_await_parked, 16384);
+    task_ptr_type waiter_2 = cotask::task<>::create(test_context_task_await_parked, 16384);
+    task_ptr_type killed   = cotask::task<>::create(test_context_task_await_parked, 16384);
+
+    CASE_EXPECT_EQ(0, target->start());
+    CASE_EXPECT_EQ(0, waiter_1->start(target.get()));
+    CASE_EXPECT_EQ(0, waiter_2->start(target.get()));
+    CASE_EXPECT_EQ(0, killed->start(target.get()));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter_1->get_status());
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter_2->get_status());
+
+    // parked tasks are not runnable
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_AWAITING, waiter_1->resume());
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_AWAITING, waiter_2->start());
+    CASE_EXPECT_EQ(0, g_test_context_task_await_wake);
+
+    // killed when parked
+    CASE_EXPECT_EQ(0, killed->kill());
+    CASE_EXPECT_TRUE(killed->is_completed());
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_EXITING, killed->get_ret_code());
+    CASE_EXPECT_EQ(1, g_test_context_task_await_wake);
+
+    CASE_EXPECT_EQ(0, target->resume());
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter_1->get_status());
+    CASE_EXPECT_EQ(1, g_test_context_task_await_wake);
+
+    // all waiters are woken once when target finished
+    CASE_EXPECT_EQ(0, target->resume());
+    CASE_EXPECT_TRUE(target->is_completed());
+    CASE_EXPECT_TRUE(waiter_1->is_completed());
+    CASE_EXPECT_TRUE(waiter_2->is_completed());
+    CASE_EXPECT_EQ(0, waiter_1->get_ret_code());
+    CASE_EXPECT_EQ(0, waiter_2->get_ret_code());
+    CASE_EXPECT_EQ(3, g_test_context_task_await_wake);
+}
+
+static int test_context_task_when_all(void *priv_data) {
+    std::vector<cotask::task<>::ptr_t> *tasks = reinterpret_cast<std::vector<cotask::task<>::ptr_t> *>(priv_data);
+    int                                 ret   = cotask::task<>::this_task()->when_all(*tasks);
+    ++g_test_context_task_await_wake;
+    return ret;
+}
+
+static int test_context_task_when_any(void *priv_data) {
+    std::vector<cotask::task<>::ptr_t> *tasks = reinterpret_cast<std::vector<cotask::task<>::ptr_t> *>(priv_data);
+    int                                 ret   = cotask::task<>::this_task()->when_any(*tasks);
+    ++g_test_context_task_await_wake;
+    return ret;
+}
+
+CASE_TEST(coroutine_task, when_all) {
+    typedef cotask::task<>::ptr_t task_ptr_type;
+    g_test_context_task_await_wake = 0;
+
+    std::vector<task_ptr_type> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(cotask::task<>::create(test_context_task_await_target, 16384));
+    }
+    task_ptr_type waiter = cotask::task<>::create(test_context_task_when_all, 16384);
+
+    // one of the tasks is finished before waiting
+    CASE_EXPECT_EQ(0, tasks[2]->start());
+    CASE_EXPECT_EQ(0, tasks[2]->kill());
+    CASE_EXPECT_EQ(0, tasks[0]->start());
+    CASE_EXPECT_EQ(0, tasks[1]->start());
+
+    CASE_EXPECT_EQ(0, waiter->start(&tasks));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+
+    CASE_EXPECT_EQ(0, tasks[0]->resume());
+    CASE_EXPECT_EQ(0, tasks[0]->resume());
+    CASE_EXPECT_TRUE(tasks[0]->is_completed());
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_IS_AWAITING, waiter->resume());
+
+    CASE_EXPECT_EQ(0, tasks[1]->resume());
+    CASE_EXPECT_EQ(0, g_test_context_task_await_wake);
+    CASE_EXPECT_EQ(0, tasks[1]->resume());
+    CASE_EXPECT_TRUE(waiter->is_completed());
+    CASE_EXPECT_EQ(0, waiter->get_ret_code());
+    CASE_EXPECT_EQ(1, g_test_context_task_await_wake);
+
+    // all finished
+    task_ptr_type finished_waiter = cotask::task<>::create(test_context_task_when_all, 16384);
+    CASE_EXPECT_EQ(0, finished_waiter->start(&tasks));
+    CASE_EXPECT_TRUE(finished_waiter->is_completed());
+    CASE_EXPECT_EQ(2, g_test_context_task_await_wake);
+
+    // bad arguments
+    tasks.push_back(task_ptr_type());
+    task_ptr_type bad_waiter = cotask::task<>::create(test_context_task_when_all, 16384);
+    CASE_EXPECT_EQ(0, bad_waiter->start(&tasks));
+    CASE_EXPECT_EQ(copp::COPP_EC_ARGS_ERROR, bad_waiter->get_ret_code());
+}
+
+CASE_TEST(coroutine_task, when_any) {
+    typedef cotask::task<>::ptr_t task_ptr_type;
+    g_test_context_task_await_wake = 0;
+
+    std::vector<task_ptr_type> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(cotask::task<>::create(test_context_task_await_target, 16384));
+        CASE_EXPECT_EQ(0, tasks.back()->start());
+    }
+    task_ptr_type waiter = cotask::task<>::create(test_context_task_when_any, 16384);
+
+    CASE_EXPECT_EQ(0, waiter->start(&tasks));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+
+    CASE_EXPECT_EQ(0, tasks[1]->resume());
+    CASE_EXPECT_EQ(0, tasks[1]->resume());
+    CASE_EXPECT_TRUE(waiter->is_completed());
+    CASE_EXPECT_EQ(1, waiter->get_ret_code());
+    CASE_EXPECT_EQ(1, g_test_context_task_await_wake);
+
+    // the others do not wake it again, even it's waiting for them again
+    task_ptr_type second_waiter = cotask::task<>::create(test_context_task_when_any, 16384);
+    std::vector<task_ptr_type> rest;
+    rest.push_back(tasks[2]);
+    CASE_EXPECT_EQ(0, second_waiter->start(&rest));
+    CASE_EXPECT_EQ(0, tasks[0]->resume());
+    CASE_EXPECT_EQ(0, tasks[0]->resume());
+    CASE_EXPECT_TRUE(tasks[0]->is_completed());
+    CASE_EXPECT_EQ(1, g_test_context_task_await_wake);
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, second_waiter->get_status());
+
+    CASE_EXPECT_EQ(0, tasks[2]->kill());
+    CASE_EXPECT_TRUE(second_waiter->is_completed());
+    CASE_EXPECT_EQ(0, second_waiter->get_ret_code());
+    CASE_EXPECT_EQ(2, g_test_context_task_await_wake);
+
+    CASE_EXPECT_EQ(copp::COPP_EC_TASK_NOT_IN_ACTION, waiter->when_any(tasks));
+}
+
+#if defined(UTIL_CONFIG_COMPILER_CXX_VARIADIC_TEMPLATES) && UTIL_CONFIG_COMPILER_CXX_VARIADIC_TEMPLATES
+static int test_context_task_when_variadic(void *priv_data) {
+    std::vector<cotask::task<>::ptr_t> &tasks = *reinterpret_cast<std::vector<cotask::task<>::ptr_t> *>(priv_data);
+    cotask::task<>::ptr_t               self  = cotask::task<>::this_task();
+
+    CASE_EXPECT_EQ(2, self->when_any(tasks[0], tasks[1].get(), tasks[2]));
+    CASE_EXPECT_EQ(0, self->when_all(tasks[0], tasks[1].get(), tasks[2]));
+    ++g_test_context_task_await_wake;
+    return 0;
+}
+
+CASE_TEST(coroutine_task, when_all_variadic) {
+    typedef cotask::task<>::ptr_t task_ptr_type;
+    g_test_context_task_await_wake = 0;
+
+    std::vector<task_ptr_type> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(cotask::task<>::create(test_context_task_await_target, 16384));
+        CASE_EXPECT_EQ(0, tasks.back()->start());
+    }
+    task_ptr_type waiter = cotask::task<>::create(test_context_task_when_variadic, 16384);
+
+    CASE_EXPECT_EQ(0, tasks[2]->kill());
+    CASE_EXPECT_EQ(0, waiter->start(&tasks));
+    CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, waiter->get_status());
+    CASE_EXPECT_EQ(0, tasks[0]->kill());
+    CASE_EXPECT_EQ(0, g_test_context_task_await_wake);
+    CASE_EXPECT_EQ(0, tasks[1]->kill());
+    CASE_EXPECT_EQ(1, g_test_context_task_await_wake);
+    CASE_EXPECT_TRUE(waiter->is_completed());
+}
+#endif
+
+#if defined(COPP_MACRO_ENABLE_EXCEPTION) && COPP_MACRO_ENABLE_EXCEPTION
+static int g_test_coroutine_task_unwind_guard  = 0;
+static int g_test_coroutine_task_unwind_resume = 0;
+
+struct test_context_task_unwind_guard {
+    ~test_context_task_unwind_guard() { ++g_test_coroutine_task_unwind_guard; }
+};
+
+static int test_context_task_unwind_action(void *) {
+    test_context_task_unwind_guard guard;
+    // never finish unless unwinded
+    while (true) {
+        cotask::this_task::get_task()->yield();
+        ++g_test_coroutine_task_unwind_resume;
+    }
+
+    return 0;
+}
+
+CASE_TEST(coroutine_task, kill_by_unwind) {
+    typedef cotask::task<>::ptr_t task_ptr_type;
+    g_test_coroutine_task_unwind_guard  = 0;
+    g_test_coroutine_task_unwind_resume = 0;
+
+    {
+        task_ptr_type co_task = cotask::task<>::create(test_context_task_unwind_action, 16384);
+        CASE_EXPECT_FALSE(co_task->is_unwind_on_kill());
+        co_task->set_unwind_on_kill(true);
+        CASE_EXPECT_TRUE(co_task->is_unwind_on_kill());
+
+        CASE_EXPECT_EQ(0, co_task->start());
+        CASE_EXPECT_EQ(0, co_task->resume());
+        CASE_EXPECT_EQ(1, g_test_coroutine_task_unwind_resume);
+        CASE_EXPECT_EQ(0, g_test_coroutine_task_unwind_guard);
+
+        CASE_EXPECT_EQ(0, co_task->kill(cotask::EN_TS_KILLED));
+        CASE_EXPECT_TRUE(co_task->is_completed());
+        CASE_EXPECT_EQ(cotask::EN_TS_KILLED, co_task->get_status());
+        CASE_EXPECT_TRUE(co_task->get_coroutine_context()->is_unwinding());
+
+        // code after yield is not executed, but destructors are called
+        CASE_EXPECT_EQ(1, g_test_coroutine_task_unwind_resume);
+        CASE_EXPECT_EQ(1, g_test_coroutine_task_unwind_guard);
+    }
+
+    // timeout by destroy
+    {
+        task_ptr_type co_task = cotask::task<>::create(test_context_task_unwind_action, 16384);
+        co_task->set_unwind_on_kill(true);
+        CASE_EXPECT_EQ(0, co_task->start());
+    }
+    CASE_EXPECT_EQ(1, g_test_coroutine_task_unwind_resume);
+    CASE_EXPECT_EQ(2, g_test_coroutine_task_unwind_guard);
+
+    // action of task not started will not run
+    {
+        task_ptr_type co_task = cotask::task<>::create(test_context_task_unwind_action, 16384);
+        co_task->set_unwind_on_kill(true);
+        CASE_EXPECT_EQ(0, co_task->cancel());
+        CASE_EXPECT_TRUE(co_task->is_completed());
+        CASE_EXPECT_EQ(cotask::EN_TS_CANCELED, co_task->get_status());
+    }
+    CASE_EXPECT_EQ(1, g_test_coroutine_task_unwind_resume);
+    CASE_EXPECT_EQ(2, g_test_coroutine_task_unwind_guard);
+}
+#endif
+
 #endif
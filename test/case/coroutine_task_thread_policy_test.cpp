@@ -0,0 +1,124 @@
+#ifdef COTASK_MACRO_ENABLED
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <libcopp/stack/stack_pool.h>
+#include <libcopp/utils/thread_policy.h>
+#include <libcotask/task.h>
+#include <libcotask/task_manager.h>
+#include <libcotask/task_pool.h>
+
+#include "frame/test_macros.h"
+
+typedef copp::stack_pool<copp::allocator::stack_allocator_malloc, util::lock::single_thread_policy> test_task_thread_policy_stack_pool_t;
+struct test_task_thread_policy_macro_coroutine {
+    typedef copp::allocator::stack_allocator_pool<test_task_thread_policy_stack_pool_t> stack_allocator_t;
+    typedef util::lock::single_thread_policy                                             thread_policy_t;
+    typedef copp::coroutine_context_container<stack_allocator_t, thread_policy_t>        coroutine_t;
+};
+
+// macro without thread_policy_t uses the default policy
+struct test_task_thread_policy_legacy_macro_task {
+    typedef uint64_t                                                 id_t;
+    typedef cotask::core::standard_int_id_allocator<uint64_t>        id_allocator_t;
+};
+
+typedef cotask::task<test_task_thread_policy_macro_coroutine, cotask::macro_task_single_thread> test_task_thread_policy_task_t;
+typedef cotask::task<cotask::macro_coroutine_single_thread, cotask::macro_task_single_thread>   test_task_thread_policy_default_stack_task_t;
+
+static int g_test_task_thread_policy_run = 0;
+
+static int test_task_thread_policy_action(void *) {
+    ++g_test_task_thread_policy_run;
+    cotask::this_task::get_task()->yield();
+    ++g_test_task_thread_policy_run;
+    return 3;
+}
+
+static int test_task_thread_policy_await_action(void *priv_data) {
+    test_task_thread_policy_task_t *other = reinterpret_cast<test_task_thread_policy_task_t *>(priv_data);
+    int                             ret   = test_task_thread_policy_task_t::this_task()->await(other);
+    return 0 == ret ? other->get_ret_code() : ret;
+}
+
+struct test_task_thread_policy_functor {
+    int operator()(void *priv_data) { return test_task_thread_policy_action(priv_data); }
+};
+
+CASE_TEST(coroutine_task, thread_policy_traits) {
+    CASE_EXPECT_TRUE((std::is_same<util::lock::default_thread_policy, cotask::task<>::thread_policy_t>::value));
+    CASE_EXPECT_TRUE((std::is_same<util::lock::default_thread_policy,
+                                   util::lock::thread_policy_of<test_task_thread_policy_legacy_macro_task>::type>::value));
+    CASE_EXPECT_TRUE((std::is_same<util::lock::single_thread_policy, test_task_thread_policy_task_t::thread_policy_t>::value));
+    CASE_EXPECT_TRUE((std::is_same<util::lock::single_thread_policy, test_task_thread_policy_stack_pool_t::thread_policy_t>::value));
+    CASE_EXPECT_TRUE((std::is_same<util::lock::single_thread_policy,
+                                   test_task_thread_policy_task_t::coroutine_t::thread_policy_t>::value));
+    CASE_EXPECT_TRUE((std::is_same<util::lock::default_thread_policy, copp::coroutine_context_default::thread_policy_t>::value));
+
+    // the legacy macro still works
+    cotask::task<cotask::macro_coroutine, test_task_thread_policy_legacy_macro_task>::ptr_t t =
+        cotask::task<cotask::macro_coroutine, test_task_thread_policy_legacy_macro_task>::create(test_task_thread_policy_action, 16384);
+    g_test_task_thread_policy_run = 0;
+    CASE_EXPECT_EQ(0, t->start());
+    CASE_EXPECT_EQ(0, t->resume());
+    CASE_EXPECT_EQ(3, t->get_ret_code());
+    CASE_EXPECT_EQ(2, g_test_task_thread_policy_run);
+}
+
+CASE_TEST(coroutine_task, thread_policy_single_thread) {
+    test_task_thread_policy_stack_pool_t::ptr_t stack_pool = test_task_thread_policy_stack_pool_t::create();
+    stack_pool->set_stack_size(64 * 1024);
+    g_test_task_thread_policy_run = 0;
+
+    {
+        copp::allocator::stack_allocator_pool<test_task_thread_policy_stack_pool_t> alloc(stack_pool);
+        test_task_thread_policy_task_t::ptr_t t1 = test_task_thread_policy_task_t::create(test_task_thread_policy_action, alloc);
+        test_task_thread_policy_task_t::ptr_t t2 = test_task_thread_policy_task_t::create(test_task_thread_policy_await_action, alloc);
+        test_task_thread_policy_task_t::ptr_t t3 = test_task_thread_policy_task_t::create(test_task_thread_policy_action, alloc);
+        t2->next(t3);
+
+        // task manager without lock
+        typedef cotask::task_manager<test_task_thread_policy_task_t> mgr_t;
+        CASE_EXPECT_TRUE((std::is_same<util::lock::dummy_lock, mgr_t::thread_policy_t::lock_type>::value));
+        mgr_t::ptr_t task_mgr = mgr_t::create();
+        CASE_EXPECT_EQ(0, task_mgr->add_task(t1));
+
+        CASE_EXPECT_EQ(0, task_mgr->start(t1->get_id()));
+        CASE_EXPECT_EQ(0, t2->start(t1.get()));
+        CASE_EXPECT_EQ(cotask::EN_TS_AWAITING, t2->get_status());
+        CASE_EXPECT_EQ(3, (int)stack_pool->get_limit().used_stack_number);
+
+        CASE_EXPECT_EQ(0, task_mgr->resume(t1->get_id()));
+        CASE_EXPECT_EQ(0, (int)task_mgr->get_task_size());
+        CASE_EXPECT_TRUE(t2->is_completed());
+        CASE_EXPECT_EQ(3, t2->get_ret_code());
+        CASE_EXPECT_EQ(cotask::EN_TS_WAITING, t3->get_status());
+        CASE_EXPECT_EQ(0, t3->resume());
+        CASE_EXPECT_EQ(4, g_test_task_thread_policy_run);
+    }
+
+    CASE_EXPECT_EQ(0, (int)stack_pool->get_limit().used_stack_number);
+}
+
+CASE_TEST(coroutine_task, thread_policy_task_pool) {
+    typedef cotask::task_pool<test_task_thread_policy_functor, cotask::macro_coroutine_single_thread, cotask::macro_task_single_thread>
+        pool_t;
+    CASE_EXPECT_TRUE((std::is_same<util::lock::single_thread_policy, pool_t::thread_policy_t>::value));
+
+    pool_t::ptr_t pool = pool_t::create(16384);
+    g_test_task_thread_policy_run = 0;
+    for (int i = 0; i < 4; ++i) {
+        test_task_thread_policy_default_stack_task_t::ptr_t t = pool->create_task(test_task_thread_policy_functor());
+        CASE_EXPECT_EQ(0, t->start());
+        CASE_EXPECT_EQ(0, t->resume());
+        CASE_EXPECT_TRUE(t->is_completed());
+    }
+
+    CASE_EXPECT_EQ(8, g_test_task_thread_policy_run);
+    CASE_EXPECT_EQ(1, (int)pool->get_free_number());
+}
+
+#endif
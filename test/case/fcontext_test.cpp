@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #include "libcopp/fcontext/all.hpp"
@@ -58,3 +59,164 @@ CASE_TEST(core, fcontext)
     ++ g_test_core_fcontext_status;
     CASE_EXPECT_EQ(g_test_core_fcontext_status, 5);
 }
+
+#if (defined(__x86_64__) || defined(__amd64__)) && !defined(_WIN32)
+#include <cfenv>
+
+copp::fcontext::fcontext_t test_core_fcontext_fpu_main_func, test_core_fcontext_fpu_func;
+char test_core_fcontext_stack_fpu[128 * 1024] = { 0 };
+
+void test_core_fcontext_func_fpu(::copp::fcontext::transfer_t src)
+{
+    // change rounding mode(both x87 control word and MXCSR) inside the context
+    fesetround(FE_UPWARD);
+    src = copp::fcontext::copp_jump_fcontext(src.fctx, UTIL_CONFIG_NULLPTR);
+
+    CASE_EXPECT_EQ(FE_UPWARD, fegetround());
+    fesetround(FE_TONEAREST);
+    copp::fcontext::copp_jump_fcontext(src.fctx, UTIL_CONFIG_NULLPTR);
+}
+
+CASE_TEST(core, fcontext_fpu_control)
+{
+    int origin_round = fegetround();
+    CASE_EXPECT_EQ(FE_TONEAREST, origin_round);
+
+    test_core_fcontext_fpu_func = copp::fcontext::copp_make_fcontext(test_core_fcontext_stack_fpu + sizeof(test_core_fcontext_stack_fpu), sizeof(test_core_fcontext_stack_fpu), test_core_fcontext_func_fpu);
+    copp::fcontext::transfer_t res = copp::fcontext::copp_jump_fcontext(test_core_fcontext_fpu_func, UTIL_CONFIG_NULLPTR);
+
+#if defined(COPP_FCONTEXT_NO_FPU_CONTROL) || defined(COPP_FCONTEXT_USE_TSX)
+    // floating point control state is not a part of the context, so the change leaks to caller
+    CASE_EXPECT_EQ(FE_UPWARD, fegetround());
+#else
+    // floating point control state is callee-saved, so it's restored when switch back
+    CASE_EXPECT_EQ(FE_TONEAREST, fegetround());
+    fesetround(FE_UPWARD);
+#endif
+
+    copp::fcontext::copp_jump_fcontext(res.fctx, UTIL_CONFIG_NULLPTR);
+
+#if defined(COPP_FCONTEXT_NO_FPU_CONTROL) || defined(COPP_FCONTEXT_USE_TSX)
+    CASE_EXPECT_EQ(FE_TONEAREST, fegetround());
+#else
+    CASE_EXPECT_EQ(FE_UPWARD, fegetround());
+#endif
+
+    fesetround(origin_round);
+}
+#endif
+
+#if defined(COPP_FCONTEXT_HAS_INLINE_JUMP) && COPP_FCONTEXT_HAS_INLINE_JUMP
+char test_core_fcontext_stack_inline[128 * 1024] = { 0 };
+
+void test_core_fcontext_func_inline(::copp::fcontext::transfer_t src)
+{
+    int *counter = reinterpret_cast<int *>(src.data);
+
+    // suspended by inline jump and resumed by inline jump
+    src = copp::fcontext::copp_jump_fcontext_inline(src.fctx, counter);
+    ++(*counter);
+
+    // suspended by copp_jump_fcontext and resumed by inline jump
+    src = copp::fcontext::copp_jump_fcontext(src.fctx, counter);
+    ++(*counter);
+
+    copp::fcontext::copp_jump_fcontext_inline(src.fctx, counter);
+}
+
+CASE_TEST(core, fcontext_inline_jump)
+{
+    // values which may be kept in callee-saved registers
+    uint64_t a = static_cast<uint64_t>(rand()) + 1, b = a * 3, c = b * 5, d = c * 7, e = d * 11;
+    uint64_t sum = a + b + c + d + e;
+    int counter = 0;
+
+    copp::fcontext::fcontext_t ctx = copp::fcontext::copp_make_fcontext(test_core_fcontext_stack_inline + sizeof(test_core_fcontext_stack_inline), sizeof(test_core_fcontext_stack_inline), test_core_fcontext_func_inline);
+
+    // start by copp_jump_fcontext
+    copp::fcontext::transfer_t res = copp::fcontext::copp_jump_fcontext(ctx, &counter);
+    CASE_EXPECT_EQ(&counter, res.data);
+    CASE_EXPECT_EQ(0, counter);
+
+    res = copp::fcontext::copp_jump_fcontext_inline(res.fctx, &counter);
+    CASE_EXPECT_EQ(&counter, res.data);
+    CASE_EXPECT_EQ(1, counter);
+
+    res = copp::fcontext::copp_jump_fcontext_inline(res.fctx, &counter);
+    CASE_EXPECT_EQ(&counter, res.data);
+    CASE_EXPECT_EQ(2, counter);
+
+    CASE_EXPECT_EQ(sum, a + b + c + d + e);
+    CASE_EXPECT_EQ(a * 1155, e);
+}
+#endif
+
+template <typename TBackend>
+struct test_core_fcontext_backend_data {
+    copp::fcontext::fcontext_t main_ctx;
+    copp::fcontext::fcontext_t b_ctx;
+    int status;
+
+    static char stack_a[128 * 1024];
+    static char stack_b[128 * 1024];
+
+    static void func_a(::copp::fcontext::transfer_t src) {
+        test_core_fcontext_backend_data *self = reinterpret_cast<test_core_fcontext_backend_data *>(src.data);
+        self->main_ctx = src.fctx;
+        ++self->status;
+
+        // jump to B directly, B jumps back to A
+        src = TBackend::jump(self->b_ctx, self);
+        CASE_EXPECT_EQ(self, src.data);
+        self->b_ctx = src.fctx;
+        ++self->status;
+
+        src = TBackend::jump(self->main_ctx, self);
+        // resumed by main again
+        self->main_ctx = src.fctx;
+        ++self->status;
+        TBackend::jump(self->main_ctx, self);
+    }
+
+    static void func_b(::copp::fcontext::transfer_t src) {
+        test_core_fcontext_backend_data *self = reinterpret_cast<test_core_fcontext_backend_data *>(src.data);
+        ++self->status;
+        TBackend::jump(src.fctx, self);
+    }
+
+    static void run() {
+        test_core_fcontext_backend_data data;
+        data.main_ctx = NULL;
+        data.status = 0;
+        data.b_ctx = TBackend::make(stack_b + sizeof(stack_b), sizeof(stack_b), func_b);
+        copp::fcontext::fcontext_t a_ctx = TBackend::make(stack_a + sizeof(stack_a), sizeof(stack_a), func_a);
+        CASE_EXPECT_TRUE(NULL != data.b_ctx);
+        CASE_EXPECT_TRUE(NULL != a_ctx);
+
+        copp::fcontext::transfer_t res = TBackend::jump(a_ctx, &data);
+        CASE_EXPECT_EQ(&data, res.data);
+        CASE_EXPECT_EQ(3, data.status);
+
+        res = TBackend::jump(res.fctx, &data);
+        CASE_EXPECT_EQ(&data, res.data);
+        CASE_EXPECT_EQ(4, data.status);
+    }
+};
+
+template <typename TBackend>
+char test_core_fcontext_backend_data<TBackend>::stack_a[128 * 1024] = { 0 };
+
+template <typename TBackend>
+char test_core_fcontext_backend_data<TBackend>::stack_b[128 * 1024] = { 0 };
+
+CASE_TEST(core, fcontext_backend)
+{
+    test_core_fcontext_backend_data<copp::fcontext::backend_fcontext>::run();
+#if defined(COPP_FCONTEXT_HAS_UCONTEXT_BACKEND) && COPP_FCONTEXT_HAS_UCONTEXT_BACKEND
+    test_core_fcontext_backend_data<copp::fcontext::backend_ucontext>::run();
+#endif
+#if defined(COPP_FCONTEXT_HAS_MINIMAL_BACKEND) && COPP_FCONTEXT_HAS_MINIMAL_BACKEND
+    test_core_fcontext_backend_data<copp::fcontext::backend_minimal>::run();
+#endif
+    test_core_fcontext_backend_data<copp::fcontext::backend_t>::run();
+}
@@ -3,10 +3,13 @@
 #include <ctime>
 #include <iostream>
 #include <set>
+#include <vector>
 
 
 #include "frame/test_macros.h"
 #include "libcotask/core/standard_int_id_allocator.h"
+#include "libcotask/core/standard_int_id_block_allocator.h"
+#include "libcotask/core/standard_int_id_slot_allocator.h"
 
 
 #if ((defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1800)) && \
@@ -55,6 +58,46 @@ CASE_TEST(coroutine_task, id_allocator_32) {
     CASE_EXPECT_GE(end_time - begin_time, (time_t)2);
 }
 
+CASE_TEST(coroutine_task, id_block_allocator_16) {
+    cotask::core::standard_int_id_block_allocator<uint16_t> alloc;
+
+    time_t begin_time = time(NULL);
+
+    size_t id_num = 3 * (1 << 8) + 100; // wrap 3 times without sleep
+    std::set<uint16_t> s;
+
+    for (size_t i = 0; i < id_num; ++i) {
+        uint16_t id = alloc.allocate();
+        CASE_EXPECT_NE(0, id);
+        CASE_EXPECT_TRUE(s.find(id) == s.end());
+        s.insert(id);
+    }
+
+    time_t end_time = time(NULL);
+    CASE_EXPECT_EQ(id_num, s.size());
+    CASE_EXPECT_LE(end_time - begin_time, (time_t)1);
+}
+
+CASE_TEST(coroutine_task, id_block_allocator_32) {
+    cotask::core::standard_int_id_block_allocator<uint32_t, 100> alloc;
+
+    size_t id_num = 3 * (1 << 16) + 100;
+    std::set<uint32_t> s;
+
+    uint32_t last_id = 0;
+    for (size_t i = 0; i < id_num; ++i) {
+        uint32_t id = alloc.allocate();
+        CASE_EXPECT_TRUE(s.find(id) == s.end());
+        s.insert(id);
+
+        // in one thread, the time part never goes back
+        CASE_EXPECT_GE(id >> 16, last_id >> 16);
+        last_id = id;
+    }
+
+    CASE_EXPECT_EQ(id_num, s.size());
+}
+
 
 #if ((defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1800)) && \
     defined(UTIL_CONFIG_COMPILER_CXX_LAMBDAS) && UTIL_CONFIG_COMPILER_CXX_LAMBDAS
@@ -93,4 +136,91 @@ CASE_TEST(coroutine_task, id_allocator_mt) {
     CASE_EXPECT_GE(end_time - begin_time, (time_t)1);
 }
 
+CASE_TEST(coroutine_task, id_block_allocator_mt) {
+    cotask::core::standard_int_id_block_allocator<uint32_t> alloc;
+
+    std::unique_ptr<std::thread> thds[4];
+    std::set<uint32_t> s[4];
+    for (int i = 0; i < 4; ++i) {
+        std::set<uint32_t> *sp = &s[i];
+        thds[i].reset(new std::thread([sp, &alloc]() {
+            size_t id_num = 36768;
+
+            for (size_t i = 0; i < id_num; ++i) {
+                uint32_t id = alloc.allocate();
+                CASE_EXPECT_TRUE(sp->find(id) == sp->end());
+                sp->insert(id);
+            }
+        }));
+    }
+
+    size_t id_num = 0;
+    for (int i = 0; i < 4; ++i) {
+        thds[i]->join();
+        id_num += 36768;
+
+        if (i != 0) {
+            s[0].insert(s[i].begin(), s[i].end());
+        }
+    }
+
+    CASE_EXPECT_EQ(id_num, s[0].size());
+}
+
+CASE_TEST(coroutine_task, id_slot_allocator_mt) {
+    typedef cotask::core::standard_int_id_slot_allocator<uint64_t> alloc_t;
+    alloc_t alloc;
+
+    std::unique_ptr<std::thread> thds[4];
+    std::set<uint64_t> s[4];
+    for (int i = 0; i < 4; ++i) {
+        std::set<uint64_t> *sp = &s[i];
+        thds[i].reset(new std::thread([sp, &alloc]() {
+            size_t id_num = 1000;
+
+            std::vector<uint64_t> ids;
+            for (size_t i = 0; i < id_num; ++i) {
+                ids.push_back(alloc.allocate());
+            }
+
+            std::set<uint64_t> freed_indexes;
+            for (size_t i = 0; i < id_num; ++i) {
+                if (0 == (i & 1)) {
+                    alloc.deallocate(ids[i]);
+                    freed_indexes.insert(alloc_t::get_index(ids[i]));
+                } else {
+                    sp->insert(ids[i]);
+                }
+            }
+
+            // slots cached by this thread are reused first, at least 64 (BLOCK_SIZE) of them are kept by this thread,
+            // the others may be taken by other threads from the global free list
+            for (size_t i = 0; i < id_num / 2; ++i) {
+                uint64_t id = alloc.allocate();
+                if (i < 64) {
+                    CASE_EXPECT_TRUE(freed_indexes.end() != freed_indexes.find(alloc_t::get_index(id)));
+                }
+                CASE_EXPECT_TRUE(sp->find(id) == sp->end());
+                sp->insert(id);
+            }
+        }));
+    }
+
+    std::set<uint64_t> indexes;
+    for (int i = 0; i < 4; ++i) {
+        thds[i]->join();
+        for (std::set<uint64_t>::iterator iter = s[i].begin(); iter != s[i].end(); ++iter) {
+            CASE_EXPECT_TRUE(indexes.insert(alloc_t::get_index(*iter)).second);
+        }
+    }
+    CASE_EXPECT_EQ(4000, (int)indexes.size());
+
+    // ids can be deallocated by any thread
+    for (int i = 0; i < 4; ++i) {
+        for (std::set<uint64_t>::iterator iter = s[i].begin(); iter != s[i].end(); ++iter) {
+            alloc.deallocate(*iter);
+        }
+    }
+}
+
 #endif
\ No newline at end of file
@@ -181,4 +181,40 @@ CASE_TEST(stack_pool_test, full_size) {
     CASE_EXPECT_TRUE(!tp2);
 
     global_stack_pool.reset();
-}
\ No newline at end of file
+}
+
+struct stack_pool_test_batch_action {
+    int operator()(void *) { return 0; }
+};
+
+static stack_pool_test_batch_action stack_pool_test_batch_factory(size_t) { return stack_pool_test_batch_action(); }
+
+CASE_TEST(stack_pool_test, create_batch) {
+    global_stack_pool = stack_pool_t::create();
+    global_stack_pool->set_max_stack_number(48);
+
+    // stacks are taken from the pool in one call
+    copp::allocator::stack_allocator_pool<stack_pool_t> alloc(global_stack_pool);
+    std::vector<stack_pool_test_task_t::ptr_t> task_arr = stack_pool_test_task_t::create_batch(32, stack_pool_test_batch_factory, alloc);
+    CASE_EXPECT_EQ(32, task_arr.size());
+    CASE_EXPECT_EQ(32, global_stack_pool->get_limit().used_stack_number);
+    for (size_t i = 0; i < task_arr.size(); ++i) {
+        CASE_EXPECT_TRUE(!!task_arr[i]);
+        CASE_EXPECT_EQ(0, task_arr[i]->start());
+        CASE_EXPECT_TRUE(task_arr[i]->is_completed());
+    }
+
+    // reuse the free stacks, and stop at the limit
+    task_arr.resize(16);
+    CASE_EXPECT_EQ(16, global_stack_pool->get_limit().free_stack_number);
+    std::vector<stack_pool_test_task_t::ptr_t> more = stack_pool_test_task_t::create_batch(64, stack_pool_test_batch_factory, alloc);
+    CASE_EXPECT_EQ(32, more.size());
+    CASE_EXPECT_EQ(48, global_stack_pool->get_limit().used_stack_number);
+    CASE_EXPECT_EQ(0, global_stack_pool->get_limit().free_stack_number);
+
+    more.clear();
+    task_arr.clear();
+    CASE_EXPECT_EQ(0, global_stack_pool->get_limit().used_stack_number);
+
+    global_stack_pool.reset();
+}